@@ -10,15 +10,23 @@
 #ifndef ARBITRARY_BIGNUM_H_00E681C94204436A9C4EC4EFAA0DE0F9
 #define ARBITRARY_BIGNUM_H_00E681C94204436A9C4EC4EFAA0DE0F9 1
 #include "cold_vector.h"
+#include "digit_kernels.h"
+#include "limb_io.h"
+#include "limb_kernels.h"
+#include "small_vector.h"
 #include "util.h"
 
 #include <utility>
 #include <compare>
 #include <iomanip>
 #include <iostream>
+#include <fstream>
+#include <optional>
+#include <string>
 #include <concepts>
 #include <algorithm>
 #include <type_traits>
+#include <vector>
 
 #include <cmath>
 #include <cstddef>
@@ -27,11 +35,31 @@
 // The Maximum value for an Arbitrarily printable number.
 inline constexpr std::size_t ARBITRARY_PRINTABLE = 999999999;
 
+template<std::size_t U>
+struct FixedBigNum;
+
+template<std::size_t U>
+struct HeapFixedBigNum;
+
+template<std::size_t MAX_VAL>
+struct PersistentBigNum;
+
+// Digit containers for ArbitraryBigNum. InMemoryLimbs keeps the first 8 digits
+// inline so small numbers never allocate, ColdLimbs keeps the digits in a file
+// for numbers too large to hold in memory.
+using InMemoryLimbs = SmallVector<std::uint32_t, 8>;
+using ColdLimbs = ColdVector<std::uint32_t>;
+
+// Digits a product of numbers outside memory may hold in RAM at once before
+// operator* hands it to mul_out_of_core, 16 MiB worth
+inline constexpr std::size_t ARBITRARY_MUL_BUDGET = std::size_t{1} << 22;
+
 /**
  *	ArbitraryBigNum is a type that makes large numbers with no fixed width.
- *	This stores everything on disk however.
+ *	The digits are kept in Storage, which is in memory unless ColdLimbs is
+ *	asked for.
  */
-template<std::size_t MAX_VAL = UINT32_MAX>
+template<std::size_t MAX_VAL = UINT32_MAX, typename Storage = InMemoryLimbs>
 struct ArbitraryBigNum {
 	static_assert(MAX_VAL != 0, "You cant have a base 0 number");
 	static_assert(MAX_VAL <= UINT32_MAX, "The base is too large");
@@ -60,9 +88,32 @@ struct ArbitraryBigNum {
 	ArbitraryBigNum(ArbitraryBigNum const& a): m_data{a.m_data}, m_signed{a.m_signed}
 	{}
 
-	ArbitraryBigNum(ArbitraryBigNum const&& a): m_data{std::move(a.m_data)}, m_signed{a.m_signed}
+	// A moved-from number can only be assigned to or destroyed
+	ArbitraryBigNum(ArbitraryBigNum&& a) noexcept(std::is_nothrow_move_constructible_v<Storage>): m_data{std::move(a.m_data)}, m_signed{a.m_signed}
+	{}
+
+	// Converts a FixedBigNum, in binary base this is a straight limb copy,
+	// other bases peel digits off with one single limb division per digit chunk.
+	template<std::size_t U>
+	ArbitraryBigNum(FixedBigNum<U> const& x): ArbitraryBigNum{x.m_data.data(), U, x.m_signed}
 	{}
 
+	// Converts between bases by going through binary limbs rather than decimal text,
+	// a change of storage alone copies the digits across
+	template<std::size_t OTHER_MAX, typename OTHER_STORAGE>
+	explicit ArbitraryBigNum(ArbitraryBigNum<OTHER_MAX, OTHER_STORAGE> const& x): m_data{}, m_signed{x.m_signed}
+	{
+		if constexpr(OTHER_MAX == MAX_VAL) {
+			for(std::size_t idx = 0; idx < x.m_data.size(); idx++) {
+				m_data.emplace_back(x.m_data[idx]);
+			}
+		} else {
+			std::vector<std::uint32_t> limbs(x.binary_limb_bound(), 0);
+			x.export_binary_limbs(limbs.data(), limbs.size());
+			assign_binary_limbs(limbs.data(), limb_active_length(limbs.data(), limbs.size()));
+		}
+	}
+
 // Assignment Operators
 	ArbitraryBigNum& operator=(std::integral auto x) {
 		ArbitraryBigNum a{x};
@@ -77,40 +128,49 @@ struct ArbitraryBigNum {
 		return *this;
 	}
 
+	// Swaps storage, x is left holding our old digits
+	ArbitraryBigNum& operator=(ArbitraryBigNum&& x) noexcept {
+		m_data.swap(x.m_data);
+		std::swap(m_signed, x.m_signed);
+		return *this;
+	}
+
+	template<std::size_t U>
+	ArbitraryBigNum& operator=(FixedBigNum<U> const& x) {
+		ArbitraryBigNum a{x};
+		m_data.swap(a.m_data);
+		m_signed = a.m_signed;
+		return *this;
+	}
+
 // Arithmetic
 	ArbitraryBigNum& operator+=(ArbitraryBigNum const& add) {
 		if(m_signed != add.m_signed) {
 			m_signed ^= true;
 			operator-=(add);
-			m_signed ^= true;
+			// A zero difference has already lost its sign, don't flip it back to -0
+			if((m_data.size() != 1) || (m_data[0] != 0)) {
+				m_signed ^= true;
+			}
 			return *this;
 		}
-		std::uint64_t carry = 0;
+		std::uint32_t carry = 0;
 		std::size_t limit = std::min(m_data.size(), add.m_data.size());
 		for(std::size_t idx = 0; idx < limit; idx++) {
-			carry += ((std::uint64_t)(m_data[idx] & 0xFFFFFFFF) + (std::uint64_t)(add.m_data[idx] & 0xFFFFFFFF));
-			m_data[idx] = carry % sc_modVal;
-			carry /= sc_modVal;
+			m_data[idx] = digit_add_carry<sc_modVal>(m_data[idx], add.m_data[idx], carry);
 		}
 
 		if(m_data.size() > limit) {
 			for(std::size_t idx = limit; (idx < m_data.size()) && (carry != 0); idx++) {
-				carry += m_data[idx] & 0xFFFFFFFF;
-				m_data[idx] = carry % sc_modVal;
-				carry /= sc_modVal;
+				m_data[idx] = digit_add_carry<sc_modVal>(m_data[idx], 0, carry);
 			}
 		} else if(add.m_data.size() > limit) {
 			for(std::size_t idx = limit; (idx < add.m_data.size()); idx++) {
-				carry += add.m_data[idx] & 0xFFFFFFFF;
-				m_data.emplace_back(carry % sc_modVal);
-				carry /= sc_modVal;
+				m_data.emplace_back(digit_add_carry<sc_modVal>(add.m_data[idx], 0, carry));
 			}
 		}
 		if(carry != 0) {
-			while(carry != 0) {
-				m_data.emplace_back(carry % sc_modVal);
-				carry /= sc_modVal;
-			}
+			m_data.emplace_back(carry);
 		}
 		return *this;
 	}
@@ -125,12 +185,29 @@ struct ArbitraryBigNum {
 		return * this;
 	}
 
-	ArbitraryBigNum operator+(ArbitraryBigNum const& add) const {
+	ArbitraryBigNum operator+(ArbitraryBigNum const& add) const& {
 		ArbitraryBigNum tmp{*this};
 		tmp += add;
 		return tmp;
 	}
 
+	// A temporary on either side already has storage the sum can be built in,
+	// so chains like a + b + c only ever allocate the first result
+	ArbitraryBigNum operator+(ArbitraryBigNum const& add) && {
+		*this += add;
+		return std::move(*this);
+	}
+
+	ArbitraryBigNum operator+(ArbitraryBigNum&& add) const& {
+		add += *this;
+		return std::move(add);
+	}
+
+	ArbitraryBigNum operator+(ArbitraryBigNum&& add) && {
+		*this += add;
+		return std::move(*this);
+	}
+
 	ArbitraryBigNum& operator-=(ArbitraryBigNum const& sub) {
 		// Prevent -0
 		if(&sub == this) {
@@ -147,39 +224,29 @@ struct ArbitraryBigNum {
 			return *this;
 		}
 
-		// If it reaches here the sign definitely flips
+		// If it reaches here the sign definitely flips, work out sub - this in place
 		if(absolute_compare(*this, sub) == std::strong_ordering::less) {
-			ArbitraryBigNum temp = sub - *this;
-			m_data.swap(temp.m_data);
+			std::uint32_t borrow = 0;
+			std::size_t own = m_data.size();
+			for(std::size_t idx = 0; idx < own; idx++) {
+				m_data[idx] = digit_sub_borrow<sc_modVal>(sub.m_data[idx], m_data[idx], borrow);
+			}
+			for(std::size_t idx = own; idx < sub.m_data.size(); idx++) {
+				m_data.emplace_back(digit_sub_borrow<sc_modVal>(sub.m_data[idx], 0, borrow));
+			}
+			shrink_number();
 			m_signed ^= true;
 			return *this;
 		}
 
-		std::uint64_t temp = 0;
-		std::uint64_t carry = 0;
+		// |this| >= |sub| here, so nothing borrows out of the top
+		std::uint32_t borrow = 0;
 		std::size_t limit = std::min(m_data.size(), sub.m_data.size());
 		for(std::size_t idx = 0; idx < limit; idx++) {
-			// As sc_modVal is unreachable in any base
-			// if it dips below it then it has clearly underflowed and as
-			// a result we then have a carry flag set :D
-			temp = sc_modVal + (m_data[idx] & 0xFFFFFFFF) - carry;
-			temp -= sub.m_data[idx] & 0xFFFFFFFF;
-			carry = temp < sc_modVal;
-			m_data[idx] = (temp % sc_modVal) & 0xFFFFFFFF;
+			m_data[idx] = digit_sub_borrow<sc_modVal>(m_data[idx], sub.m_data[idx], borrow);
 		}
-
-		if(limit == m_data.size() && (m_data.size() != sub.m_data.size())) {
-			for(std::size_t idx = limit; idx < sub.m_data.size(); idx++) {
-				temp = (sc_modVal + sub.m_data[idx]) - carry;
-				carry = temp < sc_modVal;
-				m_data.emplace_back(temp % sc_modVal);
-			}
-		} else {
-			for(std::size_t idx = limit; (idx < m_data.size()) && (carry != 0); idx++) {
-				temp = sc_modVal + (m_data[idx] & 0xFFFFFFFF) - carry;
-				carry = temp < sc_modVal;
-				m_data[idx] = temp % sc_modVal;
-			}
+		for(std::size_t idx = limit; (idx < m_data.size()) && (borrow != 0); idx++) {
+			m_data[idx] = digit_sub_borrow<sc_modVal>(m_data[idx], 0, borrow);
 		}
 
 		shrink_number();
@@ -201,51 +268,83 @@ struct ArbitraryBigNum {
 		return *this;
 	}
 
-	ArbitraryBigNum operator-(ArbitraryBigNum const& val) const {
+	ArbitraryBigNum operator-(ArbitraryBigNum const& val) const& {
 		ArbitraryBigNum temp{*this};
 		temp -= val;
 		return temp;
 	}
 
-	ArbitraryBigNum operator*(ArbitraryBigNum const& val) const {
-		if ((val == 0) || (*this == 0)) {
-			return 0;
-		}
+	ArbitraryBigNum operator-(ArbitraryBigNum const& val) && {
+		*this -= val;
+		return std::move(*this);
+	}
 
-		std::uint64_t buff = 0;
-		ArbitraryBigNum result{0};
-		for(std::size_t idx = 0; idx < val.m_data.size(); idx++) {
-			for(std::size_t idy = 0; idy < m_data.size(); idy++) {
-				if((idx + idy) >= result.m_data.size()) result.m_data.emplace_back(0);
-				buff += ((std::uint64_t)m_data[idy] & 0xFFFFFFFF) * ((std::uint64_t)val.m_data[idx]);
-				buff += ((std::uint64_t)result.m_data[idx + idy] & 0xFFFFFFFF);
-				result.m_data[idx + idy] = (buff % sc_modVal) & 0xFFFFFFFF;
-				buff /= sc_modVal;
-			}
-			while(buff != 0) {
-				result.m_data.emplace_back(buff % sc_modVal);
-				buff /= sc_modVal;
-			}
+	// this - val is -(val - this)
+	ArbitraryBigNum operator-(ArbitraryBigNum&& val) const& {
+		val -= *this;
+		if((val.m_data.size() != 1) || (val.m_data[0] != 0)) {
+			val.m_signed ^= true;
 		}
+		return std::move(val);
+	}
 
-		if(m_signed != val.m_signed) {
-			result.m_signed = true;
-		}
+	ArbitraryBigNum operator-(ArbitraryBigNum&& val) && {
+		*this -= val;
+		return std::move(*this);
+	}
 
-		result.shrink_number();	
+	ArbitraryBigNum operator*(ArbitraryBigNum const& val) const& {
+		ArbitraryBigNum temp{*this};
+		temp *= val;
+		return temp;
+	}
 
-		return result;
+	ArbitraryBigNum operator*(ArbitraryBigNum const& val) && {
+		*this *= val;
+		return std::move(*this);
+	}
+
+	ArbitraryBigNum operator*(ArbitraryBigNum&& val) const& {
+		val *= *this;
+		return std::move(val);
+	}
+
+	ArbitraryBigNum operator*(ArbitraryBigNum&& val) && {
+		*this *= val;
+		return std::move(*this);
 	}
 
+	// The product goes back into our own storage
 	ArbitraryBigNum& operator*=(ArbitraryBigNum const& val) {
-		ArbitraryBigNum temp = this->operator*(val);
-		m_data.swap(temp.m_data);
-		m_signed = temp.m_signed;
+		if((val == 0) || (*this == 0)) {
+			assign_limbs(nullptr, 0, false);
+			return *this;
+		}
+
+		// Copying both sides and the product into memory would blow the budget
+		if constexpr(!requires { m_data.data(); }) {
+			if((2 * (m_data.size() + val.m_data.size())) > ARBITRARY_MUL_BUDGET) {
+				ArbitraryBigNum temp = mul_out_of_core(*this, val, ARBITRARY_MUL_BUDGET);
+				m_data.swap(temp.m_data);
+				m_signed = temp.m_signed;
+				return *this;
+			}
+		}
+
+		auto lhs = to_limbs();
+		auto rhs = val.to_limbs();
+		std::vector<std::uint32_t> product(lhs.size() + rhs.size(), 0);
+		digit_mul<sc_modVal>(product.data(), lhs.data(), lhs.size(), rhs.data(), rhs.size());
+		assign_limbs(product.data(), product.size(), m_signed != val.m_signed);
 		return *this;
 	}
 
 	// Cut out allocations for small numbers and whatever
 	ArbitraryBigNum& operator*=(width32int auto val) {
+		if((val == 0) || (*this == 0)) {
+			assign_limbs(nullptr, 0, false);
+			return *this;
+		}
 		if constexpr(!std::is_unsigned_v<decltype(val)>) {
 			if(std::signbit(val)) {
 				m_signed ^= true;
@@ -253,24 +352,29 @@ struct ArbitraryBigNum {
 			}
 		}
 		std::uint64_t buff = 0;
-		for(auto idx = 0; idx < m_data.size(); idx++) {
+		for(std::size_t idx = 0; idx < m_data.size(); idx++) {
 			buff += ((std::uint64_t)m_data[idx]&0xFFFFFFFF) * ((std::uint64_t)val & 0xFFFFFFFF);
-			m_data[idx] = buff % sc_modVal;
-			buff /= sc_modVal;
+			buff = digit_split<sc_modVal>(buff, m_data[idx]);
 		}
 		while(buff != 0) {
-			m_data.emplace_back(buff % sc_modVal);
-			buff /= sc_modVal;
+			std::uint32_t digit = 0;
+			buff = digit_split<sc_modVal>(buff, digit);
+			m_data.emplace_back(digit);
 		}
 		return *this;
 	}
 
-	ArbitraryBigNum operator*(width32int auto val) const {
+	ArbitraryBigNum operator*(width32int auto val) const& {
 		ArbitraryBigNum temp{*this};
 		temp *= val;
 		return temp;
 	}
 
+	ArbitraryBigNum operator*(width32int auto val) && {
+		*this *= val;
+		return std::move(*this);
+	}
+
 	ArbitraryBigNum operator/(ArbitraryBigNum const& val) const {
 		return simple_divide(val).first;
 	}
@@ -283,20 +387,26 @@ struct ArbitraryBigNum {
 	}
 
 	ArbitraryBigNum& operator/=(width32int auto val) {
+		std::uint64_t div = (std::uint64_t)val & 0xFFFFFFFF;
 		if constexpr(std::is_signed_v<decltype(val)>) {
 			if(std::signbit(val)) {
 				m_signed ^= true;
+				div = (0 - (std::int64_t)val) & 0xFFFFFFFF;
 			}
 		}
 		std::uint64_t carry = 0;
 		for(int idx = m_data.size() - 1; idx > 0; idx--) {
 			carry += m_data[idx] & 0xFFFFFFFF;
-			m_data[idx] = carry / val & 0xFFFFFFFF;
-			carry %= val;
+			m_data[idx] = carry / div & 0xFFFFFFFF;
+			carry %= div;
 			carry *= sc_modVal;
 		}
 		carry += (m_data[0] & 0xFFFFFFFF);
-		m_data[0] = carry / val;
+		m_data[0] = carry / div;
+		shrink_number();
+		if((m_data.size() == 1) && (m_data[0] == 0)) {
+			m_signed = false;
+		}
 		return *this;
 	}
 
@@ -317,6 +427,102 @@ struct ArbitraryBigNum {
 		return *this;
 	}
 
+	// this /= div when div is known to divide this exactly, this works on binary
+	// limbs from the low end up so other bases pay for a conversion each way.
+	// If div does not divide this the result is garbage, dividing by 0 gives 0.
+	ArbitraryBigNum& divexact(ArbitraryBigNum const& div) {
+		std::vector<std::uint32_t> num(binary_limb_bound(), 0);
+		std::vector<std::uint32_t> den(div.binary_limb_bound(), 0);
+		export_binary_limbs(num.data(), num.size());
+		div.export_binary_limbs(den.data(), den.size());
+		std::vector<std::uint32_t> quotient(num.size(), 0);
+		auto len = limb_divexact(quotient.data(), num.data(), num.size(), den.data(), den.size());
+		ArbitraryBigNum result{quotient.data(), len, m_signed != div.m_signed};
+		m_data.swap(result.m_data);
+		m_signed = result.m_signed;
+		return *this;
+	}
+
+// Bit queries, these work on the magnitude and ignore the sign
+// They need a binary base so they are only available when MAX_VAL is UINT32_MAX
+	// Number of bits needed to hold the magnitude, 0 for 0
+	std::size_t bit_width() const requires (MAX_VAL == UINT32_MAX) {
+		return ((m_data.size() - 1) * 32) + std::bit_width(m_data[m_data.size() - 1]);
+	}
+
+	// Number of set bits in the magnitude
+	std::size_t popcount() const requires (MAX_VAL == UINT32_MAX) {
+		std::size_t count = 0;
+		for(std::size_t idx = 0; idx < m_data.size(); idx++) {
+			count += std::popcount(m_data[idx]);
+		}
+		return count;
+	}
+
+	// Number of zero bits below the lowest set bit
+	// Like std::countr_zero this is the full width for 0, which is the 32 bits of its single limb
+	std::size_t countr_zero() const requires (MAX_VAL == UINT32_MAX) {
+		for(std::size_t idx = 0; idx < m_data.size(); idx++) {
+			if(m_data[idx] != 0) {
+				return (idx * 32) + std::countr_zero(m_data[idx]);
+			}
+		}
+		return m_data.size() * 32;
+	}
+
+	bool test_bit(std::size_t bit) const requires (MAX_VAL == UINT32_MAX) {
+		if((bit >> 5) >= m_data.size()) return false;
+		return (m_data[bit >> 5] >> (bit & 0x1F)) & 1;
+	}
+
+	// Sets (or clears) a single bit, growing the number if needed
+	ArbitraryBigNum& set_bit(std::size_t bit, bool value = true) requires (MAX_VAL == UINT32_MAX) {
+		std::size_t word = bit >> 5;
+		std::uint32_t mask = 1U << (bit & 0x1F);
+		if(value) {
+			while(m_data.size() <= word) {
+				m_data.emplace_back(0);
+			}
+			m_data[word] |= mask;
+		} else if(word < m_data.size()) {
+			m_data[word] &= ~mask;
+			shrink_number();
+			if((m_data.size() == 1) && (m_data[0] == 0)) {
+				m_signed = false;
+			}
+		}
+		return *this;
+	}
+
+// Raw limb import/export, only the magnitude goes through. Outside of the
+// binary base these convert to binary limbs first
+	// Number of W words export_limbs needs for the magnitude, 0 for 0
+	template<limb_word W>
+	std::size_t export_size() const {
+		std::vector<std::uint32_t> limbs(binary_limb_bound(), 0);
+		export_binary_limbs(limbs.data(), limbs.size());
+		return limb_word_count<W>(limbs.data(), limbs.size());
+	}
+
+	// Writes the magnitude into count words, zero padded or truncated to fit
+	template<limb_word W>
+	void export_limbs(W* out, std::size_t count, WordOrder order = WordOrder::least_significant_first, std::endian endian = std::endian::native) const {
+		std::vector<std::uint32_t> limbs(binary_limb_bound(), 0);
+		export_binary_limbs(limbs.data(), limbs.size());
+		limb_export_words(out, count, limbs.data(), limbs.size(), order, endian);
+	}
+
+	// Replaces this with the non-negative value held in count words
+	template<limb_word W>
+	ArbitraryBigNum& import_limbs(W const* words, std::size_t count, WordOrder order = WordOrder::least_significant_first, std::endian endian = std::endian::native) {
+		std::vector<std::uint32_t> limbs(((count * sizeof(W)) + 3) / 4, 0);
+		limb_import_words(limbs.data(), limbs.size(), words, count, order, endian);
+		ArbitraryBigNum a{limbs.data(), limbs.size(), false};
+		m_data.swap(a.m_data);
+		m_signed = false;
+		return *this;
+	}
+
 // Masking and bitshifts and whatever
 	// Left Shift Assignment operator
 	// IMPORTANT: It only works if you use UINT32_MAX as MAX_VAL
@@ -458,15 +664,188 @@ struct ArbitraryBigNum {
 		return lhs.m_data[0] <=> static_cast<std::uint32_t>(rhs);
 	}
 
-	friend std::ostream& operator<<(std::ostream& os, ArbitraryBigNum const& abg) {
+	/*
+	 * Writes the number in decimal to os, most significant digit first,
+	 * through a fixed sc_exportBuffer character buffer. Printable numbers
+	 * are streamed straight out of their storage. Any other base is converted
+	 * to base 10^9 first: in memory with digit_from_limbs, or for storage like
+	 * ColdLimbs past a sixteenth of budget digits with convert_out_of_core into
+	 * a ColdLimbs temporary, so memory stays around budget digits however large
+	 * the number is. Returns whether os is still good.
+	 */
+	bool export_decimal(std::ostream& os, std::size_t budget = ARBITRARY_MUL_BUDGET) const {
+		if constexpr((MAX_VAL != ARBITRARY_PRINTABLE) && !requires { m_data.data(); }) {
+			if(m_data.size() > out_of_core_block(budget)) {
+				auto decimal = ArbitraryBigNum<ARBITRARY_PRINTABLE, ColdLimbs>::template convert_out_of_core<sc_modVal>(
+						[this](std::size_t idx) -> std::uint32_t { return m_data[idx]; }, m_data.size(), budget);
+				decimal.m_signed = m_signed;
+				return decimal.export_decimal(os, budget);
+			}
+		}
+
+		std::vector<char> buffer(sc_exportBuffer + 16);
+		std::size_t used = 0;
+		auto flush = [&]() {
+			os.write(buffer.data(), used);
+			used = 0;
+		};
+		auto put_digits = [&](auto digitAt, std::size_t count) {
+			if(m_signed) {
+				buffer[used++] = '-';
+			}
+			// The top group has no leading zeroes, every other one is 9 characters wide
+			auto top = std::to_string(digitAt(count - 1));
+			for(char c : top) {
+				buffer[used++] = c;
+			}
+			for(std::size_t idx = count - 1; idx > 0; idx--) {
+				std::uint32_t group = digitAt(idx - 1);
+				for(std::size_t pos = 9; pos > 0; pos--) {
+					buffer[used + pos - 1] = '0' + (group % 10);
+					group /= 10;
+				}
+				used += 9;
+				if(used >= sc_exportBuffer) {
+					flush();
+				}
+			}
+			flush();
+		};
+
 		if constexpr(MAX_VAL == ARBITRARY_PRINTABLE) {
-			if(abg.m_signed) {
-				os << '-';
+			put_digits([this](std::size_t idx) -> std::uint32_t { return m_data[idx]; }, m_data.size());
+		} else {
+			std::vector<std::uint32_t> limbs(binary_limb_bound(), 0);
+			export_binary_limbs(limbs.data(), limbs.size());
+			std::vector<std::uint32_t> digits(digit_from_limbs_bound<1000000000>(limbs.size()));
+			std::size_t count = std::max<std::size_t>(digit_from_limbs<1000000000>(digits.data(), limbs.data(), limbs.size()), 1);
+			put_digits([&digits](std::size_t idx) { return digits[idx]; }, count);
+		}
+		return os.good();
+	}
+
+	// Writes the number in decimal to the file at path, replacing it. Returns false
+	// if the file can't be opened or written
+	bool export_decimal(std::string const& path, std::size_t budget = ARBITRARY_MUL_BUDGET) const {
+		std::ofstream file{path, std::ios::out | std::ios::binary | std::ios::trunc};
+		if(!file.is_open()) return false;
+		return export_decimal(file, budget) && file.flush().good();
+	}
+
+	/*
+	 * Replaces this with the decimal integer at the front of is: leading
+	 * whitespace, an optional sign and then digits up to the first character
+	 * that isn't one. The text goes through the stream buffer a character at
+	 * a time and is packed into 9 digit groups as it arrives, so only the
+	 * base 10^9 digits are ever held, never the text. Other bases are
+	 * converted with digit_to_limbs and digit_from_limbs, and the result is
+	 * written into our own storage in order. For storage like ColdLimbs the
+	 * groups spill into a ColdLimbs file once there are more than a sixteenth
+	 * of budget of them and are converted with convert_out_of_core, so memory
+	 * stays around budget digits for any length of text. Returns false and
+	 * sets failbit, leaving this alone, when there are no digits.
+	 */
+	bool import_decimal(std::istream& is, std::size_t budget = ARBITRARY_MUL_BUDGET) {
+		using traits = std::istream::traits_type;
+		std::istream::sentry guard{is};
+		if(!guard) return false;
+		auto* buffer = is.rdbuf();
+		auto ch = buffer->sgetc();
+		bool negative = false;
+		if((ch == '-') || (ch == '+')) {
+			negative = (ch == '-');
+			ch = buffer->snextc();
+		}
+
+		// Full groups of 9 digits most significant first, then the leftover digits
+		std::vector<std::uint32_t> groups;
+		std::optional<ColdLimbs> spill;
+		std::size_t block = out_of_core_block(budget);
+		auto push = [&](std::uint32_t full) {
+			if(spill) {
+				spill->emplace_back(full);
+				return;
 			}
-			os << abg.m_data[abg.m_data.size() - 1];
-			for(int itr = abg.m_data.size() - 2; itr >= 0; itr--) {
-				os << std::setw(9) << std::setfill('0') << abg.m_data[itr];
+			if constexpr(!requires { m_data.data(); }) {
+				if(groups.size() == block) {
+					spill = ColdLimbs{};
+					for(auto val : groups) {
+						spill->emplace_back(val);
+					}
+					spill->emplace_back(full);
+					groups = {};
+					return;
+				}
+			}
+			groups.push_back(full);
+		};
+		std::uint32_t group = 0;
+		std::uint32_t scale = 1;
+		bool found = false;
+		while(!traits::eq_int_type(ch, traits::eof()) && (ch >= '0') && (ch <= '9')) {
+			group = (group * 10) + (ch - '0');
+			scale *= 10;
+			if(scale == 1000000000) {
+				push(group);
+				group = 0;
+				scale = 1;
+			}
+			found = true;
+			ch = buffer->snextc();
+		}
+		if(traits::eq_int_type(ch, traits::eof())) {
+			is.setstate(std::ios::eofbit);
+		}
+		if(!found) {
+			is.setstate(std::ios::failbit);
+			return false;
+		}
+
+		if(spill) {
+			ColdLimbs const& text = *spill;
+			std::size_t count = text.size();
+			auto result = convert_out_of_core<1000000000>([&text, count](std::size_t idx) -> std::uint32_t { return text[count - 1 - idx]; }, count, budget);
+			result *= scale;
+			result += group;
+			result.m_signed = negative && (result != 0);
+			*this = std::move(result);
+			return true;
+		}
+
+		// The leftover digits shift every full group up
+		std::reverse(groups.begin(), groups.end());
+		groups.push_back(0);
+		digit_mul_1<1000000000>(groups.data(), groups.size(), scale);
+		digit_add_1<1000000000>(groups.data(), groups.size(), group);
+		if constexpr(MAX_VAL == ARBITRARY_PRINTABLE) {
+			assign_limbs(groups.data(), groups.size(), negative);
+		} else {
+			std::vector<std::uint32_t> limbs(digit_to_limbs_bound<1000000000>(groups.size()));
+			std::size_t count = digit_to_limbs<1000000000>(limbs.data(), groups.data(), groups.size());
+			if constexpr(MAX_VAL == UINT32_MAX) {
+				assign_limbs(limbs.data(), count, negative);
+			} else {
+				std::vector<std::uint32_t> digits(digit_from_limbs_bound<sc_modVal>(count));
+				assign_limbs(digits.data(), digit_from_limbs<sc_modVal>(digits.data(), limbs.data(), count), negative);
 			}
+		}
+		return true;
+	}
+
+	// Replaces this with the decimal integer in the file at path, read through a
+	// large stream buffer. Returns false if the file can't be opened or has no digits
+	bool import_decimal(std::string const& path, std::size_t budget = ARBITRARY_MUL_BUDGET) {
+		std::vector<char> buffer(sc_importBuffer);
+		std::ifstream file;
+		file.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+		file.open(path, std::ios::in | std::ios::binary);
+		if(!file.is_open()) return false;
+		return import_decimal(file, budget);
+	}
+
+	friend std::ostream& operator<<(std::ostream& os, ArbitraryBigNum const& abg) {
+		if constexpr(MAX_VAL == ARBITRARY_PRINTABLE) {
+			abg.export_decimal(os);
 		} else if(stream_hex_mode(os)) {
 			// Hexedecimal output mode
 			os << abg.m_data[abg.m_data.size() - 1];
@@ -474,15 +853,7 @@ struct ArbitraryBigNum {
 				os << std::setw(8) << std::setfill('0') << abg.m_data[idx];
 			}
 		} else {
-			ArbitraryBigNum<ARBITRARY_PRINTABLE> result{0};
-			for(int idx = abg.m_data.size() - 1; idx >= 0; idx--) {
-				result *= sc_modVal;
-				result += abg.m_data[idx];
-			}
-			if(abg.m_signed) {
-				result *= -1;
-			}
-			os << result;
+			abg.export_decimal(os);
 		}
 		return os;
 	}
@@ -509,7 +880,211 @@ struct ArbitraryBigNum {
 		}
 	}
 
+	// Top k binary limbs of |lhs| * |rhs| with the sign of the product, the
+	// product shifted right by 32 * (binary limbs of lhs + binary limbs of rhs - k).
+	// The low partial products are never formed so the magnitude can come out
+	// one below the exact value, but never above it.
+	friend ArbitraryBigNum mul_high(ArbitraryBigNum const& lhs, ArbitraryBigNum const& rhs, std::size_t k) {
+		std::vector<std::uint32_t> lhsLimbs(lhs.binary_limb_bound(), 0);
+		std::vector<std::uint32_t> rhsLimbs(rhs.binary_limb_bound(), 0);
+		lhs.export_binary_limbs(lhsLimbs.data(), lhsLimbs.size());
+		rhs.export_binary_limbs(rhsLimbs.data(), rhsLimbs.size());
+		std::size_t lhsLen = std::max<std::size_t>(limb_active_length(lhsLimbs.data(), lhsLimbs.size()), 1);
+		std::size_t rhsLen = std::max<std::size_t>(limb_active_length(rhsLimbs.data(), rhsLimbs.size()), 1);
+		k = std::min(k, lhsLen + rhsLen);
+		if(std::min(lhsLen, rhsLen) < limb_mul_high_limbs) {
+			std::vector<std::uint32_t> full(lhsLen + rhsLen, 0);
+			limb_mul_basecase(full.data(), lhsLimbs.data(), lhsLen, rhsLimbs.data(), rhsLen);
+			return ArbitraryBigNum{full.data() + (full.size() - k), k, lhs.m_signed != rhs.m_signed};
+		}
+		std::vector<std::uint32_t> high(k + 10, 0);
+		auto at = limb_mul_high(high.data(), lhsLimbs.data(), lhsLen, rhsLimbs.data(), rhsLen, k);
+		return ArbitraryBigNum{high.data() + at, k, lhs.m_signed != rhs.m_signed};
+	}
+
+	/*
+	 * lhs * rhs without ever holding more than about budget digits in memory,
+	 * for numbers in storage like ColdLimbs that may be larger than RAM. Both
+	 * operands are cut into blocks that get multiplied in memory with the usual
+	 * kernels. The block products are summed one anti-diagonal at a time, so
+	 * once a diagonal is done its low block is final and is appended to the
+	 * result in order. Operands are read block by block and the result is only
+	 * ever written sequentially.
+	 */
+	friend ArbitraryBigNum mul_out_of_core(ArbitraryBigNum const& lhs, ArbitraryBigNum const& rhs, std::size_t budget) {
+		ArbitraryBigNum result{0U};
+		if((lhs == 0) || (rhs == 0)) return result;
+
+		std::size_t lhsLen = lhs.m_data.size();
+		std::size_t rhsLen = rhs.m_data.size();
+		std::size_t lhsBlocks = 0;
+		std::size_t rhsBlocks = 0;
+		std::size_t headroom = 0;
+		// Two operand blocks, a block product and the accumulator all have to fit
+		std::size_t block = std::max<std::size_t>(std::max(lhsLen, rhsLen), 1);
+		for(;;) {
+			lhsBlocks = (lhsLen + block - 1) / block;
+			rhsBlocks = (rhsLen + block - 1) / block;
+			// The accumulator needs to hold a diagonal of up to min(blocks) products
+			headroom = 1;
+			for(std::uint64_t reach = 1; reach <= std::min(lhsBlocks, rhsBlocks); reach *= sc_modVal) {
+				headroom++;
+			}
+			std::size_t needed = (6 * block) + headroom + digit_mul_scratch<sc_modVal>(block);
+			if((needed <= budget) || (block == 1)) break;
+			block = std::max<std::size_t>(block / 2, 1);
+		}
+
+		std::size_t width = (2 * block) + headroom;
+		std::vector<std::uint32_t> lhsBlock(block);
+		std::vector<std::uint32_t> rhsBlock(block);
+		std::vector<std::uint32_t> product(2 * block);
+		std::vector<std::uint32_t> acc(width, 0);
+		std::vector<std::uint32_t> scratch(digit_mul_scratch<sc_modVal>(block));
+		auto load = [block](ArbitraryBigNum const& num, std::size_t idx, std::uint32_t* out) {
+			std::size_t start = idx * block;
+			std::size_t len = std::min(block, num.m_data.size() - start);
+			for(std::size_t pos = 0; pos < len; pos++) {
+				out[pos] = num.m_data[start + pos];
+			}
+			std::fill(out + len, out + block, 0);
+		};
+
+		std::size_t written = 0;
+		std::size_t total = lhsLen + rhsLen;
+		auto emit = [&](std::size_t count) {
+			for(std::size_t idx = 0; (idx < count) && (written < total); idx++, written++) {
+				if(written == 0) {
+					result.m_data[0] = acc[idx];
+				} else {
+					result.m_data.emplace_back(acc[idx]);
+				}
+			}
+		};
+
+		for(std::size_t diag = 0; diag < (lhsBlocks + rhsBlocks - 1); diag++) {
+			std::size_t first = (diag >= rhsBlocks) ? (diag - rhsBlocks + 1) : 0;
+			std::size_t last = std::min(diag, lhsBlocks - 1);
+			for(std::size_t idx = first; idx <= last; idx++) {
+				load(lhs, idx, lhsBlock.data());
+				load(rhs, diag - idx, rhsBlock.data());
+				digit_mul_n<sc_modVal>(product.data(), lhsBlock.data(), rhsBlock.data(), block, scratch.data());
+				digit_add_at<sc_modVal>(acc.data(), width, 0, product.data(), 2 * block);
+			}
+			// Nothing later reaches below the next diagonal, the low block is done
+			emit(block);
+			std::copy(acc.begin() + block, acc.end(), acc.begin());
+			std::fill(acc.end() - block, acc.end(), 0);
+		}
+		emit(width);
+
+		result.shrink_number();
+		result.m_signed = (lhs.m_signed != rhs.m_signed) && (result != 0);
+		return result;
+	}
+
 private:
+	template<std::size_t, typename>
+	friend struct ArbitraryBigNum;
+
+	template<std::size_t>
+	friend struct FixedBigNum;
+
+	template<std::size_t>
+	friend struct HeapFixedBigNum;
+
+	template<std::size_t>
+	friend struct PersistentBigNum;
+
+	// Builds the number from len little-endian binary limbs
+	ArbitraryBigNum(std::uint32_t const* limbs, std::size_t len, bool sign): m_data{}, m_signed{sign}
+	{
+		assign_binary_limbs(limbs, limb_active_length(limbs, len));
+	}
+
+	// Upper bound on the number of binary limbs needed to hold this number
+	std::size_t binary_limb_bound() const {
+		return ((m_data.size() * std::bit_width(MAX_VAL)) / 32) + 1;
+	}
+
+	// Fills an empty m_data from len little-endian binary limbs
+	void assign_binary_limbs(std::uint32_t const* limbs, std::size_t len) {
+		if constexpr(MAX_VAL == UINT32_MAX) {
+			for(std::size_t idx = 0; idx < len; idx++) {
+				m_data.emplace_back(limbs[idx]);
+			}
+		} else {
+			std::vector<std::uint32_t> digits(digit_from_limbs_bound<sc_modVal>(len));
+			std::size_t count = digit_from_limbs<sc_modVal>(digits.data(), limbs, len);
+			if constexpr(requires { m_data.reserve(count); }) {
+				m_data.reserve(count);
+			}
+			for(std::size_t idx = 0; idx < count; idx++) {
+				m_data.emplace_back(digits[idx]);
+			}
+		}
+
+		if(m_data.size() == 0) {
+			m_data.emplace_back(0);
+			m_signed = false;
+		}
+	}
+
+	// Writes the magnitude into len little-endian binary limbs, anything past len is truncated
+	void export_binary_limbs(std::uint32_t* out, std::size_t len) const {
+		std::fill(out, out + len, 0);
+		if constexpr(MAX_VAL == UINT32_MAX) {
+			for(std::size_t idx = 0; idx < std::min(len, m_data.size()); idx++) {
+				out[idx] = m_data[idx];
+			}
+		} else {
+			auto digits = to_limbs();
+			std::vector<std::uint32_t> limbs(digit_to_limbs_bound<sc_modVal>(digits.size()));
+			std::size_t count = digit_to_limbs<sc_modVal>(limbs.data(), digits.data(), digits.size());
+			std::copy_n(limbs.data(), std::min(count, len), out);
+		}
+	}
+
+	// Copies the digits out of m_data into contiguous memory
+	std::vector<std::uint32_t> to_limbs() const {
+		std::vector<std::uint32_t> limbs(m_data.size());
+		for(std::size_t idx = 0; idx < m_data.size(); idx++) {
+			limbs[idx] = m_data[idx];
+		}
+		return limbs;
+	}
+
+	// Builds a number out of len contiguous digits, leading zeroes are dropped
+	static ArbitraryBigNum from_limbs(std::uint32_t const* limbs, std::size_t len, bool sign) {
+		ArbitraryBigNum result{0U};
+		result.assign_limbs(limbs, len, sign);
+		return result;
+	}
+
+	// Overwrites the digits with len contiguous digits, reusing the storage we already have
+	void assign_limbs(std::uint32_t const* limbs, std::size_t len, bool sign) {
+		static constexpr std::uint32_t zero = 0;
+		len = limb_active_length(limbs, len);
+		m_signed = sign && (len != 0);
+		if(len == 0) {
+			limbs = &zero;
+			len = 1;
+		}
+		if constexpr(requires { m_data.reserve(len); }) {
+			m_data.reserve(len);
+		}
+		while(m_data.size() > len) {
+			m_data.pop_back();
+		}
+		std::size_t idx = 0;
+		for(; idx < m_data.size(); idx++) {
+			m_data[idx] = limbs[idx];
+		}
+		for(; idx < len; idx++) {
+			m_data.emplace_back(limbs[idx]);
+		}
+	}
+
 	// Remove leading zeroes from the number :D
 	void shrink_number() {
 		while((m_data.size() != 1) 
@@ -518,49 +1093,109 @@ private:
 		}
 	}
 
+	// Long division over contiguous digits in any base. Like the built-in types the
+	// quotient is truncated and the remainder takes the sign of the dividend.
 	std::pair<ArbitraryBigNum, ArbitraryBigNum> simple_divide(ArbitraryBigNum const& val) const {
 		auto res = std::pair<ArbitraryBigNum, ArbitraryBigNum>{0,*this};
 		if((*this == 0) || (val == 0)) return res;
-		auto check = absolute_compare(*this, val); 
-		if(check == std::weak_ordering::less) {
+		if(absolute_compare(*this, val) == std::strong_ordering::less) {
 			return res;
 		}
-		if(check == std::strong_ordering::equal) {
-			return {1,0};
-		}
-
-		if constexpr(MAX_VAL == UINT32_MAX) {
-			// I can do bitshifts and stuff :DDDD
-			std::size_t len_divisor = val.m_data.size() - 1;
-			std::size_t len_dividend = m_data.size() - 1;
-
-			if(len_divisor > len_dividend) return res;
 
-			int dividend_pop_bits = (32 - std::countl_zero(m_data[len_dividend])) + (len_dividend * 32);
-			int divisor_pop_bits = (32 - std::countl_zero(val.m_data[len_divisor])) + (len_divisor * 32);
+		auto num = to_limbs();
+		auto div = val.to_limbs();
+		num.push_back(0);
+		std::vector<std::uint32_t> quot(m_data.size() - div.size() + 1);
+		digit_divmod_n<sc_modVal>(quot.data(), num.data(), m_data.size(), div.data(), div.size());
+		return {from_limbs(quot.data(), quot.size(), m_signed != val.m_signed), from_limbs(num.data(), div.size(), m_signed)};
+	}
 
-			int operations = (dividend_pop_bits - divisor_pop_bits);
+	// Digits convert_out_of_core converts in memory at once, small enough next to
+	// budget that the block products of mul_out_of_core still fit
+	static std::size_t out_of_core_block(std::size_t budget) {
+		return std::max<std::size_t>(budget / 16, 1);
+	}
 
-			if(operations < 0) return res;
+	// len digits in base FROM, least significant first, as a number in our base
+	template<std::uint64_t FROM>
+	static ArbitraryBigNum convert_block(std::uint32_t const* digits, std::size_t len) {
+		if constexpr(FROM == sc_modVal) {
+			return from_limbs(digits, len, false);
+		} else if constexpr(FROM == (std::uint64_t)UINT32_MAX + 1) {
+			return ArbitraryBigNum{digits, len, false};
+		} else {
+			std::vector<std::uint32_t> limbs(digit_to_limbs_bound<FROM>(len));
+			std::size_t count = digit_to_limbs<FROM>(limbs.data(), digits, len);
+			return ArbitraryBigNum{limbs.data(), count, false};
+		}
+	}
 
-			ArbitraryBigNum divisor = val << operations;
-			while((absolute_compare(divisor, val) != std::strong_ordering::less) && (operations >= 0)) {
-				res.first<<=1;
-				if(res.second >= divisor) {
-					res.second -= divisor;
-					res.first++;
+	/*
+	 * The len digits of a base FROM magnitude, digitAt(idx) giving them least
+	 * significant first, converted to our base without holding much more than
+	 * budget digits in memory. Blocks of out_of_core_block(budget) digits are
+	 * converted in memory and joined bottom up as hi * FROM^k + lo, where the
+	 * products go through mul_out_of_core and the powers FROM^k are squared up
+	 * in our own storage. There is no division, so nothing ever needs the
+	 * whole number in memory at once. The digits are read in increasing order
+	 * within each block.
+	 */
+	template<std::uint64_t FROM, typename DigitAt>
+	static ArbitraryBigNum convert_out_of_core(DigitAt const& digitAt, std::size_t len, std::size_t budget) {
+		if constexpr(FROM == sc_modVal) {
+			// Same base, the digits only need copying across
+			ArbitraryBigNum result{0U};
+			for(std::size_t idx = 0; idx < len; idx++) {
+				if(idx == 0) {
+					result.m_data[0] = digitAt(0);
+				} else {
+					result.m_data.emplace_back(digitAt(idx));
 				}
-				divisor >>= 1;
-				operations--;
 			}
+			result.shrink_number();
+			return result;
+		} else {
+			std::size_t block = out_of_core_block(budget);
+			// powers[j] is FROM^(block * 2^j) in our base
+			std::vector<ArbitraryBigNum> powers;
+			auto convert = [&](auto& self, std::size_t start, std::size_t count) -> ArbitraryBigNum {
+				if(count <= block) {
+					std::vector<std::uint32_t> digits(count);
+					for(std::size_t idx = 0; idx < count; idx++) {
+						digits[idx] = digitAt(start + idx);
+					}
+					return convert_block<FROM>(digits.data(), count);
+				}
+				// Split at the largest block * 2^level below count
+				std::size_t level = 0;
+				while((block << (level + 1)) < count) {
+					level++;
+				}
+				if(powers.empty()) {
+					std::vector<std::uint32_t> one(block + 1, 0);
+					one[block] = 1;
+					powers.push_back(convert_block<FROM>(one.data(), one.size()));
+				}
+				while(powers.size() <= level) {
+					powers.push_back(mul_out_of_core(powers.back(), powers.back(), budget));
+				}
+				std::size_t split = block << level;
+				auto hi = self(self, start + split, count - split);
+				auto result = mul_out_of_core(hi, powers[level], budget);
+				// Let go of hi before the low half is converted
+				hi = ArbitraryBigNum{0U};
+				result += self(self, start, split);
+				return result;
+			};
+			return convert(convert, 0, len);
 		}
-
-		return res;
 	}
 
 private:
 	static constexpr std::uint64_t	sc_modVal = MAX_VAL + 1; // Modulo and divide value to be used
-	ColdVector<std::uint32_t>		m_data;					 // Digit Data in reversed Order.
+	static constexpr std::size_t	sc_exportBuffer = std::size_t{1} << 16; // Characters export_decimal writes at a time
+	static constexpr std::size_t	sc_importBuffer = std::size_t{1} << 20; // Stream buffer import_decimal reads files through
+	Storage							m_data;					 // Digit Data in reversed Order.
 	bool							m_signed;				 // If the number carries a sign
 };
 
@@ -0,0 +1,549 @@
+/*
+ * File:      bench.cpp
+ * Author:    Daniel Hannon
+ *
+ * Copyright: 2024 Daniel Hannon
+ *
+ * Brief: Rough timings for the hot kernels, run it on an idle machine.
+ */
+
+#include "arbitrary_bignum.h"
+#include "binary_poly.h"
+#include "fixed_base_pow.h"
+#include "fixed_bignum.h"
+#include "limb_kernels.h"
+#include "remainder_tree.h"
+#include "rns.h"
+#include "special_modulus.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
+// Timestamp counter ticks where there is one, nanoseconds otherwise
+static std::uint64_t ticks() {
+#if defined(__x86_64__)
+	return __rdtsc();
+#else
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+// Average ticks per call of fn over reps calls
+template<typename F>
+static double time_per_call(std::size_t reps, F&& fn) {
+	fn();
+	auto start = ticks();
+	for(std::size_t idx = 0; idx < reps; idx++) {
+		fn();
+	}
+	return (double)(ticks() - start) / reps;
+}
+
+// Best of five batches, for the short kernels where one interruption skews the average
+template<typename F>
+static double best_per_call(std::size_t reps, F&& fn) {
+	double best = time_per_call(reps / 5, fn);
+	for(std::size_t idx = 1; idx < 5; idx++) {
+		best = std::min(best, time_per_call(reps / 5, fn));
+	}
+	return best;
+}
+
+static std::vector<std::uint32_t> random_limbs(std::size_t len) {
+	static std::mt19937 rng{12345};
+	std::vector<std::uint32_t> limbs(len);
+	for(auto& limb : limbs) {
+		limb = rng();
+	}
+	return limbs;
+}
+
+// Keeps the optimizer from throwing the results away
+static volatile std::uint32_t g_sink;
+
+// Makes the optimizer forget what value holds, so work on it can't be hoisted out of the timing loop
+template<typename T>
+static void clobber(T& value) {
+	asm volatile("" : "+m"(value));
+}
+
+static void report(std::string const& name, std::size_t limbs, double perCall, double work) {
+	std::cout << std::left << std::setw(28) << name
+			  << std::right << std::setw(8) << limbs
+			  << std::setw(14) << std::fixed << std::setprecision(1) << perCall
+			  << std::setw(12) << std::setprecision(3) << (perCall / work) << '\n';
+}
+
+static void bench_mul_kernels() {
+	std::cout << "\n== Multiplication kernels (cycles/call, cycles/limb product) ==\n";
+	for(std::size_t len : {4, 8, 16, 32, 64, 128}) {
+		auto lhs = random_limbs(len);
+		auto rhs = random_limbs(len);
+		std::vector<std::uint32_t> res(2 * len);
+		std::size_t reps = 2000000 / len;
+
+		auto schoolbook = time_per_call(reps, [&]() {
+			for(std::size_t idx = 0; idx < len; idx++) {
+				res[idx + len] = limb_addmul_1(res.data() + idx, lhs.data(), len, rhs[idx]);
+			}
+			g_sink = res[len];
+		});
+		report("limb_addmul_1 rows", len, schoolbook, (double)len * len);
+
+		auto basecase = time_per_call(reps, [&]() {
+			limb_mul_basecase(res.data(), lhs.data(), len, rhs.data(), len);
+			g_sink = res[len];
+		});
+		report("limb_mul_basecase", len, basecase, (double)len * len);
+
+#ifdef LIMB_KERNELS_WORDS
+		auto addmul = time_per_call(reps * 16, [&]() {
+			g_sink = word_addmul_1(res.data(), lhs.data(), len / 2, 0x9E3779B97F4A7C15ULL) & 0xFFFFFFFF;
+		});
+		report("word_addmul_1", len, addmul, (double)len);
+#endif
+	}
+}
+
+static void bench_fixed_mul() {
+	std::cout << "\n== FixedBigNum operator* (cycles/call) ==\n";
+	FixedBigNum<32> lhs{0};
+	FixedBigNum<32> rhs{0};
+	auto lhsLimbs = random_limbs(16);
+	auto rhsLimbs = random_limbs(16);
+	for(std::size_t idx = 16; idx > 0; idx--) {
+		lhs <<= 32;
+		rhs <<= 32;
+		lhs += lhsLimbs[idx - 1];
+		rhs += rhsLimbs[idx - 1];
+	}
+	auto perCall = time_per_call(200000, [&]() {
+		auto product = lhs * rhs;
+		g_sink = product.popcount();
+	});
+	report("int1024 16x16 limbs", 16, perCall, 256.0);
+}
+
+// Fills the low len limbs of a FixedBigNum with random data
+template<std::size_t U>
+static FixedBigNum<U> random_fixed(std::size_t len) {
+	FixedBigNum<U> value{0};
+	auto limbs = random_limbs(len);
+	for(std::size_t idx = len; idx > 0; idx--) {
+		value <<= 32;
+		value += limbs[idx - 1];
+	}
+	return value;
+}
+
+static void bench_special_modulus() {
+	std::cout << "\n== Reduction of a 1042 bit product (cycles/call) ==\n";
+	for(std::int64_t offset : {1, -1, 569}) {
+		SpecialModulus<34> reducer{521, offset};
+		auto const& mod = reducer.modulus();
+		auto value = random_fixed<34>(33);
+		auto generic = time_per_call(200, [&]() {
+			g_sink = (value % mod).popcount();
+		});
+		auto folded = time_per_call(20000, [&]() {
+			g_sink = reducer.reduce(value).popcount();
+		});
+		std::string name = (offset < 0) ? "2^521 + " + std::to_string(-offset) : "2^521 - " + std::to_string(offset);
+		report(name + " operator%", 33, generic, 1.0);
+		report(name + " fold", 33, folded, 1.0);
+	}
+}
+
+static void bench_divexact() {
+	std::cout << "\n== Exact division, 2n by n limbs (cycles/call) ==\n";
+	for(std::size_t len : {2, 4, 8, 16}) {
+		auto quotient = random_fixed<32>(len);
+		auto divisor = random_fixed<32>(len);
+		auto product = quotient * divisor;
+		auto generic = time_per_call(2000, [&]() {
+			g_sink = (product / divisor).popcount();
+		});
+		auto exact = time_per_call(20000, [&]() {
+			auto temp = product;
+			g_sink = temp.divexact(divisor).popcount();
+		});
+		report("FixedBigNum operator/", len, generic, 1.0);
+		report("FixedBigNum divexact", len, exact, 1.0);
+	}
+
+	ArbitraryBigNum<> quotient{0};
+	ArbitraryBigNum<> divisor{0};
+	auto quotientLimbs = random_limbs(8);
+	auto divisorLimbs = random_limbs(8);
+	quotient.import_limbs(quotientLimbs.data(), quotientLimbs.size());
+	divisor.import_limbs(divisorLimbs.data(), divisorLimbs.size());
+	auto product = quotient * divisor;
+	auto generic = time_per_call(200, [&]() {
+		g_sink = (product / divisor).popcount();
+	});
+	auto exact = time_per_call(2000, [&]() {
+		auto temp = product;
+		g_sink = temp.divexact(divisor).popcount();
+	});
+	report("ArbitraryBigNum operator/", 8, generic, 1.0);
+	report("ArbitraryBigNum divexact", 8, exact, 1.0);
+}
+
+static void bench_mod_many() {
+	std::cout << "\n== 256 limb number mod 4096 moduli (cycles/call, cycles/modulus) ==\n";
+	auto num = random_fixed<256>(256);
+	auto moduli = random_limbs(4096);
+	for(auto& mod : moduli) {
+		mod |= 1;
+	}
+	auto separate = time_per_call(3, [&]() {
+		for(auto mod : moduli) {
+			auto temp = num;
+			g_sink = temp.divmod(mod);
+		}
+	});
+	report("divmod per modulus", 256, separate, moduli.size());
+	auto batched = time_per_call(10, [&]() {
+		g_sink = mod_u32_many(num, moduli)[0];
+	});
+	report("mod_u32_many", 256, batched, moduli.size());
+	RemainderTree tree{moduli};
+	auto walked = time_per_call(10, [&]() {
+		g_sink = tree.reduce(num)[0];
+	});
+	report("RemainderTree::reduce", 256, walked, moduli.size());
+}
+
+static void bench_fixed_base_pow() {
+	std::cout << "\n== 1024 bit modulus, 256 bit exponents (cycles/call) ==\n";
+	auto mod = random_fixed<32>(32);
+	mod.set_bit(1023);
+	auto base = random_fixed<32>(31);
+	auto exp = random_fixed<32>(8);
+	auto plain = time_per_call(20, [&]() {
+		g_sink = modpow(base, exp, mod).popcount();
+	});
+	report("modpow", 32, plain, 1.0);
+	for(std::size_t window : {4, 6, 8}) {
+		FixedBasePow<32> table{base, mod, 256, window};
+		auto fixed = time_per_call(200, [&]() {
+			g_sink = table.pow(exp).popcount();
+		});
+		report("FixedBasePow w=" + std::to_string(window), 32, fixed, 1.0);
+	}
+}
+
+static void bench_rns() {
+	std::cout << "\n== 1024 bit modular multiplication (cycles/call) ==\n";
+	auto mod = random_fixed<32>(32);
+	mod.set_bit(1023);
+	mod.set_bit(0);
+	auto lhs = random_fixed<32>(31);
+	auto rhs = random_fixed<32>(31);
+	auto plain = time_per_call(20000, [&]() {
+		g_sink = mul_mod(lhs, rhs, mod).popcount();
+	});
+	report("mul_mod", 32, plain, 1.0);
+
+	// 34 primes give M > 2^1054, above 4 * P
+	RnsMontgomery<34, 32> reducer{mod};
+	auto rnsLhs = reducer.enter(lhs);
+	auto rnsRhs = reducer.enter(rhs);
+	auto montgomery = time_per_call(20000, [&]() {
+		g_sink = reducer.mul(rnsLhs, rnsRhs).residues()[0];
+	});
+	report("RnsMontgomery<34>::mul", 68, montgomery, 1.0);
+
+	auto lanes = time_per_call(200000, [&]() {
+		rnsLhs *= rnsRhs;
+		g_sink = rnsLhs.residues()[0];
+	});
+	report("RnsNum<68> lane multiply", 68, lanes, 68.0);
+}
+
+static void bench_clmul() {
+	std::cout << "\n== Carry-less multiplication (cycles/call) ==\n";
+	for(std::size_t len : {4, 16, 32, 64}) {
+		auto lhs = random_fixed<128>(len);
+		auto rhs = random_fixed<128>(len);
+		auto shifted = time_per_call(len <= 16 ? 200 : 20, [&]() {
+			FixedBigNum<128> result{0};
+			for(std::size_t bit = 0; bit < rhs.bit_width(); bit++) {
+				if(rhs.test_bit(bit)) {
+					result ^= lhs << bit;
+				}
+			}
+			g_sink = result.popcount();
+		});
+		auto product = time_per_call(20000, [&]() {
+			g_sink = clmul(lhs, rhs).popcount();
+		});
+		report("shift and XOR", len, shifted, 1.0);
+		report("clmul", len, product, 1.0);
+	}
+
+	std::cout << "\n== GF(2^n) multiplication (cycles/call) ==\n";
+	SparsePolyModulus<8> ghash{128, {7, 2, 1, 0}};
+	auto lhs = ghash.reduce(random_fixed<8>(4));
+	auto rhs = ghash.reduce(random_fixed<8>(4));
+	auto gf128 = time_per_call(200000, [&]() {
+		g_sink = ghash.mul(lhs, rhs).popcount();
+	});
+	report("GF(2^128) mul", 4, gf128, 1.0);
+	SparsePolyModulus<40> wide{1279, {216, 0}};
+	auto wideLhs = wide.reduce(random_fixed<40>(40));
+	auto wideRhs = wide.reduce(random_fixed<40>(40));
+	auto gf1279 = time_per_call(20000, [&]() {
+		g_sink = wide.mul(wideLhs, wideRhs).popcount();
+	});
+	auto gf1279sq = time_per_call(20000, [&]() {
+		g_sink = wide.square(wideLhs).popcount();
+	});
+	report("GF(2^1279) mul", 40, gf1279, 1.0);
+	report("GF(2^1279) square", 40, gf1279sq, 1.0);
+}
+
+template<std::size_t U>
+static void bench_width(std::string const& name) {
+	auto lhs = random_fixed<U>(U);
+	auto rhs = random_fixed<U>(U);
+	auto lhsHalf = random_fixed<U>((U + 1) / 2);
+	auto rhsHalf = random_fixed<U>((U + 1) / 2);
+	auto add = best_per_call(1000000, [&]() {
+		clobber(lhs);
+		g_sink = (lhs + rhs).limbs().back();
+	});
+	auto sub = best_per_call(1000000, [&]() {
+		clobber(lhsHalf);
+		g_sink = (lhsHalf - rhs).limbs().back();
+	});
+	auto cmp = best_per_call(1000000, [&]() {
+		clobber(lhs);
+		g_sink = (lhs < rhs);
+	});
+	auto mulFull = best_per_call(200000, [&]() {
+		clobber(lhs);
+		g_sink = (lhs * rhs).limbs().back();
+	});
+	auto mulHalf = best_per_call(200000, [&]() {
+		clobber(lhsHalf);
+		g_sink = (lhsHalf * rhsHalf).limbs().back();
+	});
+	report(name + " +", U, add, 1.0);
+	report(name + " -", U, sub, 1.0);
+	report(name + " <", U, cmp, 1.0);
+	report(name + " * truncated", U, mulFull, 1.0);
+	report(name + " * half width", U, mulHalf, 1.0);
+}
+
+static void bench_small_widths() {
+	std::cout << "\n== Small fixed widths (cycles/call) ==\n";
+	bench_width<4>("int128");
+	bench_width<8>("int256");
+	bench_width<16>("int512");
+	bench_width<32>("int1024");
+}
+
+static void bench_mul_high() {
+	std::cout << "\n== Top half of a product (cycles/call) ==\n";
+	for(std::size_t len : {16, 32, 64, 128}) {
+		auto lhsLimbs = random_limbs(len);
+		auto rhsLimbs = random_limbs(len);
+		std::vector<std::uint32_t> full(2 * len);
+		std::vector<std::uint32_t> high(len + 10);
+		auto product = best_per_call(20000, [&]() {
+			limb_mul_basecase(full.data(), lhsLimbs.data(), len, rhsLimbs.data(), len);
+			g_sink = full[len];
+		});
+		auto top = best_per_call(20000, [&]() {
+			auto at = limb_mul_high(high.data(), lhsLimbs.data(), len, rhsLimbs.data(), len, len);
+			g_sink = high[at];
+		});
+		report("limb_mul_basecase", len, product, 1.0);
+		report("limb_mul_high", len, top, 1.0);
+	}
+}
+
+static void bench_small_values() {
+	std::cout << "\n== Small ArbitraryBigNum temporaries, in memory and in cold storage (cycles/call) ==\n";
+	std::uint64_t seed = 12345;
+	auto hot = best_per_call(200000, [&]() {
+		ArbitraryBigNum<> a{seed};
+		ArbitraryBigNum<> b{a + 1};
+		g_sink = b.popcount();
+	});
+	auto cold = best_per_call(500, [&]() {
+		ArbitraryBigNum<UINT32_MAX, ColdLimbs> a{seed};
+		ArbitraryBigNum<UINT32_MAX, ColdLimbs> b{a + 1};
+		g_sink = b.popcount();
+	});
+	// Each sum after the first is built in the previous temporary
+	auto chain = best_per_call(500, [&]() {
+		ArbitraryBigNum<UINT32_MAX, ColdLimbs> a{seed};
+		g_sink = (a + a + a + a).popcount();
+	});
+	report("InMemoryLimbs", 2, hot, 1.0);
+	report("ColdLimbs", 2, cold, 1.0);
+	report("ColdLimbs a + a + a + a", 2, chain, 1.0);
+}
+
+template<std::size_t MAX_VAL>
+static void bench_arbitrary_mul(std::string const& name) {
+	for(std::size_t len : {16, 64, 256, 1024}) {
+		auto lhsLimbs = random_limbs(len);
+		auto rhsLimbs = random_limbs(len);
+		ArbitraryBigNum<> lhsBinary{0};
+		ArbitraryBigNum<> rhsBinary{0};
+		lhsBinary.import_limbs(lhsLimbs.data(), len);
+		rhsBinary.import_limbs(rhsLimbs.data(), len);
+		ArbitraryBigNum<MAX_VAL> lhs{lhsBinary};
+		ArbitraryBigNum<MAX_VAL> rhs{rhsBinary};
+		auto product = best_per_call(std::max<std::size_t>(5, 200000 / (len * len)), [&]() {
+			g_sink = (lhs * rhs) == 0;
+		});
+		report(name, len, product, 1.0);
+	}
+}
+
+static void bench_out_of_core() {
+	std::cout << "\n== ColdLimbs products in memory and out of core (cycles/call) ==\n";
+	std::size_t len = 1024;
+	auto lhsLimbs = random_limbs(len);
+	auto rhsLimbs = random_limbs(len);
+	ArbitraryBigNum<> lhsHot{0};
+	ArbitraryBigNum<> rhsHot{0};
+	lhsHot.import_limbs(lhsLimbs.data(), len);
+	rhsHot.import_limbs(rhsLimbs.data(), len);
+	ArbitraryBigNum<UINT32_MAX, ColdLimbs> lhs{lhsHot};
+	ArbitraryBigNum<UINT32_MAX, ColdLimbs> rhs{rhsHot};
+	auto whole = best_per_call(5, [&]() {
+		g_sink = (lhs * rhs) == 0;
+	});
+	report("operator*", len, whole, 1.0);
+	for(std::size_t budget : {8192, 2048, 512}) {
+		auto blocked = best_per_call(5, [&]() {
+			g_sink = mul_out_of_core(lhs, rhs, budget) == 0;
+		});
+		report("mul_out_of_core, budget " + std::to_string(budget), len, blocked, 1.0);
+	}
+}
+
+static void bench_print() {
+	std::cout << "\n== Printing a binary ArbitraryBigNum in decimal (cycles/call) ==\n";
+	for(std::size_t len : {64, 512, 4096}) {
+		auto limbs = random_limbs(len);
+		ArbitraryBigNum<> num{0};
+		num.import_limbs(limbs.data(), len);
+		auto print = best_per_call(std::max<std::size_t>(5, 200000 / (len * 8)), [&]() {
+			std::stringstream out;
+			out << num;
+			g_sink = out.str().size();
+		});
+		report("operator<<", len, print, 1.0);
+	}
+}
+
+static void bench_parse() {
+	std::cout << "\n== Reading decimal text into ArbitraryBigNum (cycles/call) ==\n";
+	for(std::size_t len : {64, 512, 4096}) {
+		auto limbs = random_limbs(len);
+		ArbitraryBigNum<> num{0};
+		num.import_limbs(limbs.data(), len);
+		ArbitraryBigNum<ARBITRARY_PRINTABLE> decimal{num};
+		std::stringstream text;
+		num.export_decimal(text);
+		auto parse = best_per_call(std::max<std::size_t>(5, 200000 / (len * 8)), [&]() {
+			std::stringstream in{text.str()};
+			ArbitraryBigNum<> result{0};
+			result.import_decimal(in);
+			g_sink = result.popcount();
+		});
+		auto convert = best_per_call(std::max<std::size_t>(5, 200000 / (len * 8)), [&]() {
+			ArbitraryBigNum<> result{decimal};
+			g_sink = result.popcount();
+		});
+		report("import_decimal", len, parse, 1.0);
+		report("ArbitraryBigNum<> from base 10^9", len, convert, 1.0);
+	}
+}
+
+static void bench_decimal() {
+	std::cout << "\n== Base 10^9 ArbitraryBigNum arithmetic (cycles/call) ==\n";
+	std::size_t len = 256;
+	auto lhsLimbs = random_limbs(len);
+	auto rhsLimbs = random_limbs(len);
+	ArbitraryBigNum<> lhsBinary{0};
+	ArbitraryBigNum<> rhsBinary{0};
+	lhsBinary.import_limbs(lhsLimbs.data(), len);
+	rhsBinary.import_limbs(rhsLimbs.data(), len);
+	ArbitraryBigNum<ARBITRARY_PRINTABLE> lhs{lhsBinary};
+	ArbitraryBigNum<ARBITRARY_PRINTABLE> rhs{rhsBinary};
+	auto add = best_per_call(20000, [&]() {
+		g_sink = (lhs + rhs) == 0;
+	});
+	auto sub = best_per_call(20000, [&]() {
+		g_sink = (lhs - rhs) == 0;
+	});
+	auto small = best_per_call(20000, [&]() {
+		g_sink = (lhs * 999999937U) == 0;
+	});
+	auto mul = best_per_call(100, [&]() {
+		g_sink = (lhs * rhs) == 0;
+	});
+	auto half = rhs / 1000000000U;
+	for(std::size_t idx = 0; idx < (len / 2); idx++) {
+		half = half / 1000000000U;
+	}
+	auto div = best_per_call(100, [&]() {
+		g_sink = (lhs / half) == 0;
+	});
+	report("operator+", len, add, 1.0);
+	report("operator-", len, sub, 1.0);
+	report("operator*(std::uint32_t)", len, small, 1.0);
+	report("operator*", len, mul, 1.0);
+	report("operator/ by half the length", len, div, 1.0);
+}
+
+static void bench_arbitrary_muls() {
+	std::cout << "\n== ArbitraryBigNum products, Karatsuba and Toom-3 past the thresholds (cycles/call) ==\n";
+	bench_arbitrary_mul<UINT32_MAX>("ArbitraryBigNum<>");
+	bench_arbitrary_mul<ARBITRARY_PRINTABLE>("ArbitraryBigNum<PRINTABLE>");
+}
+
+int main() {
+#if defined(__x86_64__)
+	std::cout << "Timings are in TSC ticks" << std::endl;
+#else
+	std::cout << "Timings are in nanoseconds" << std::endl;
+#endif
+	std::cout << std::left << std::setw(28) << "kernel" << std::right << std::setw(8) << "limbs"
+			  << std::setw(14) << "per call" << std::setw(12) << "per unit" << '\n';
+	bench_mul_kernels();
+	bench_fixed_mul();
+	bench_special_modulus();
+	bench_divexact();
+	bench_mod_many();
+	bench_fixed_base_pow();
+	bench_rns();
+	bench_clmul();
+	bench_small_widths();
+	bench_mul_high();
+	bench_small_values();
+	bench_arbitrary_muls();
+	bench_decimal();
+	bench_out_of_core();
+	bench_print();
+	bench_parse();
+	return 0;
+}
@@ -0,0 +1,148 @@
+/*
+ * File:      binary_poly.h
+ * Author:    Daniel Hannon
+ *
+ * Copyright: 2024 Daniel Hannon
+ */
+
+#ifndef BINARY_POLY_H_5E1A7C3F9B2D4E68A0C4F7B1D3E9A265
+#define BINARY_POLY_H_5E1A7C3F9B2D4E68A0C4F7B1D3E9A265 1
+
+#include "fixed_bignum.h"
+#include "limb_kernels.h"
+
+#include <algorithm>
+#include <array>
+#include <initializer_list>
+#include <span>
+#include <stdexcept>
+
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * FixedBigNum magnitudes read as binary polynomials, bit i is the
+ * coefficient of x^i. This is the arithmetic behind CRCs, GHASH and GF(2^n)
+ * fields: addition is XOR and multiplication is carry-less. Signs are ignored,
+ * every result is non-negative.
+ */
+
+// Full carry-less product of the magnitudes into res, returns its length in limbs
+template<std::size_t U>
+std::size_t clmul_full(std::uint32_t* res, FixedBigNum<U> const& lhs, FixedBigNum<U> const& rhs) {
+	auto lhsLimbs = lhs.limbs();
+	auto rhsLimbs = rhs.limbs();
+	std::size_t len = lhsLimbs.size() + rhsLimbs.size();
+	if(std::min(lhsLimbs.size(), rhsLimbs.size()) < limb_clmul_karatsuba_limbs) {
+		limb_clmul_basecase(res, lhsLimbs.data(), lhsLimbs.size(), rhsLimbs.data(), rhsLimbs.size());
+		return len;
+	}
+	// Karatsuba wants both sides the same length, the shorter one is zero padded
+	std::size_t n = std::max(lhsLimbs.size(), rhsLimbs.size());
+	std::array<std::uint32_t, U> lhsPad{};
+	std::array<std::uint32_t, U> rhsPad{};
+	std::array<std::uint32_t, limb_clmul_scratch(U)> scratch;
+	std::copy(lhsLimbs.begin(), lhsLimbs.end(), lhsPad.begin());
+	std::copy(rhsLimbs.begin(), rhsLimbs.end(), rhsPad.begin());
+	limb_clmul_n(res, lhsPad.data(), rhsPad.data(), n, scratch.data());
+	return 2 * n;
+}
+
+// lhs * rhs over GF(2), truncated to U limbs like operator*
+template<std::size_t U>
+FixedBigNum<U> clmul(FixedBigNum<U> const& lhs, FixedBigNum<U> const& rhs) {
+	std::array<std::uint32_t, 2 * U> product;
+	std::size_t len = clmul_full(product.data(), lhs, rhs);
+	FixedBigNum<U> result{0};
+	result.import_limbs(product.data(), len);
+	return result;
+}
+
+// val^2 over GF(2), truncated to U limbs
+template<std::size_t U>
+FixedBigNum<U> clsquare(FixedBigNum<U> const& val) {
+	auto limbs = val.limbs();
+	std::array<std::uint32_t, 2 * U> square;
+	limb_clsquare(square.data(), limbs.data(), limbs.size());
+	FixedBigNum<U> result{0};
+	result.import_limbs(square.data(), 2 * limbs.size());
+	return result;
+}
+
+/*
+ * Arithmetic modulo a sparse binary polynomial f = x^degree + x^taps... such
+ * as the trinomial x^233 + x^74 + 1 or the GHASH pentanomial
+ * x^128 + x^7 + x^2 + x + 1, given as {233, {74, 0}} and {128, {7, 2, 1, 0}}.
+ * mul() and square() take the full double width product and fold it back
+ * with limb_clreduce_sparse, which is a handful of shifted XORs per limb
+ * instead of a polynomial division.
+ *
+ * There can be up to four taps, each below degree, and degree can be at
+ * most 32 * U so that reduced values fit, anything else throws
+ * std::invalid_argument.
+ */
+template<std::size_t U>
+struct SparsePolyModulus {
+	SparsePolyModulus(std::size_t degree, std::initializer_list<std::size_t> taps) : m_degree{degree}, m_tapCount{0}, m_taps{}
+	{
+		if(degree > 32 * U) {
+			throw std::invalid_argument("Modulus degree does not fit in the FixedBigNum");
+		}
+		if(taps.size() > m_taps.size()) {
+			throw std::invalid_argument("Modulus has more than four taps");
+		}
+		for(auto tap : taps) {
+			if(tap >= degree) {
+				throw std::invalid_argument("Modulus tap is not below the degree");
+			}
+			m_taps[m_tapCount++] = tap;
+		}
+	}
+
+	// val mod f
+	FixedBigNum<U> reduce(FixedBigNum<U> const& val) const {
+		auto limbs = val.limbs();
+		std::array<std::uint32_t, U> data;
+		std::copy(limbs.begin(), limbs.end(), data.begin());
+		return fold(data.data(), limbs.size());
+	}
+
+	// (lhs * rhs) mod f, both should already be reduced
+	FixedBigNum<U> mul(FixedBigNum<U> const& lhs, FixedBigNum<U> const& rhs) const {
+		std::array<std::uint32_t, 2 * U> product;
+		std::size_t len = clmul_full(product.data(), lhs, rhs);
+		return fold(product.data(), len);
+	}
+
+	// val^2 mod f, val should already be reduced
+	FixedBigNum<U> square(FixedBigNum<U> const& val) const {
+		auto limbs = val.limbs();
+		std::array<std::uint32_t, 2 * U> square;
+		limb_clsquare(square.data(), limbs.data(), limbs.size());
+		return fold(square.data(), 2 * limbs.size());
+	}
+
+	std::size_t degree() const {
+		return m_degree;
+	}
+
+	// Exponents of every term of f below the leading one
+	std::span<std::size_t const> taps() const {
+		return {m_taps.data(), m_tapCount};
+	}
+
+private:
+	FixedBigNum<U> fold(std::uint32_t* data, std::size_t len) const {
+		limb_clreduce_sparse(data, len, m_degree, m_taps.data(), m_tapCount);
+		FixedBigNum<U> result{0};
+		result.import_limbs(data, std::min(len, U));
+		return result;
+	}
+
+private:
+	std::size_t				   m_degree;   // Degree of f
+	std::size_t				   m_tapCount; // Number of taps in use
+	std::array<std::size_t, 4> m_taps;	   // Exponents of the lower terms of f
+};
+
+#endif // BINARY_POLY_H_5E1A7C3F9B2D4E68A0C4F7B1D3E9A265
@@ -38,7 +38,10 @@ struct ColdVector {
 				  m_vectorSize{0},
 				  m_fileName{get_uuid()},
 				  m_fileOwner{true},
-				  m_fileStream{m_fileName, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc}
+				  m_fileStream{m_fileName, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc},
+				  m_fileOffset{0},
+				  m_dirty{false},
+				  m_borrowed{false}
 	{
 		static_assert(BUFF_SIZE != 0, "Cannot have 0 buffer");
 		for(auto const& v : inp) {
@@ -52,8 +55,13 @@ struct ColdVector {
 										 m_vectorSize{other.m_vectorSize},
 										 m_fileName{get_uuid()},
 										 m_fileOwner{true},
-										 m_fileStream{m_fileName, std::ios::in | std::ios::out | std::ios::binary}
+										 m_fileStream{m_fileName, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc},
+										 m_fileOffset{other.m_fileOffset},
+										 m_dirty{other.m_dirty},
+										 m_borrowed{false}
 	{
+		// Anything still sitting in the other stream has to reach the file first
+		const_cast<ColdVector&>(other).m_fileStream.flush();
 		std::ifstream temp{other.m_fileName};
 		if(m_fileStream.is_open() && temp.is_open()) {
 			while(!temp.eof()) {
@@ -65,17 +73,39 @@ struct ColdVector {
 		temp.close();
 	}
 
-	ColdVector(ColdVector&& a): m_buffer{std::move(a.m_buffer)},
+	ColdVector(ColdVector&& a) noexcept : m_buffer{std::move(a.m_buffer)},
 								m_buffIndex{a.m_buffIndex},
 								m_buffSize{a.m_buffSize},
 								m_vectorSize{a.m_vectorSize},
 								m_fileName{std::move(a.m_fileName)},
-								m_fileOwner{true},
-								m_fileStream{std::move(a.m_fileStream)}
+								m_fileOwner{a.m_fileOwner},
+								m_fileStream{std::move(a.m_fileStream)},
+								m_fileOffset{a.m_fileOffset},
+								m_dirty{a.m_dirty},
+								m_borrowed{a.m_borrowed}
 	{
 		a.m_fileOwner = false;
 	}
 
+	// Opens size elements stored offset bytes into an existing file without reading
+	// them. The file is only borrowed, it is never written to or removed: the first
+	// write copies the elements into a file of our own.
+	ColdVector(std::string const& fileName, std::size_t offset, std::size_t size): m_buffer{},
+										 m_buffIndex{0},
+										 m_buffSize{0},
+										 m_vectorSize{size},
+										 m_fileName{fileName},
+										 m_fileOwner{false},
+										 m_fileStream{m_fileName, std::ios::in | std::ios::binary},
+										 m_fileOffset{offset},
+										 m_dirty{false},
+										 m_borrowed{true}
+	{
+		if(!m_fileStream.is_open()) {
+			throw std::runtime_error("Cannot open " + fileName);
+		}
+	}
+
 
 	~ColdVector() {
 		m_fileStream.close();
@@ -93,6 +123,14 @@ struct ColdVector {
 		return *this;
 	}
 
+	// Takes over the other file, ours goes away with the other vector
+	ColdVector& operator=(ColdVector&& other) noexcept {
+		if(this != &other) {
+			swap(other);
+		}
+		return *this;
+	}
+
 	// Amount of elements currently stored in the vector
 	std::size_t size() const noexcept {
 		return m_vectorSize;
@@ -113,14 +151,7 @@ struct ColdVector {
 		if(idx >= m_vectorSize) {
 			throw std::out_of_range("Element is out of bounds!");
 		}
-
-		if((idx < m_buffIndex)
-	       || (idx >= (m_buffIndex + m_buffSize))) {
-			dump_buffer();
-			load_buffer_at(idx);
-		}
-
-		return m_buffer[idx - m_buffIndex];
+		return this->operator[](idx);
 	}
 
 	template<class... Args>
@@ -131,6 +162,7 @@ struct ColdVector {
 			load_buffer_at(m_vectorSize);
 		}
 		m_buffer[m_vectorSize - m_buffIndex] = T(std::forward<Args>(args)...);
+		m_dirty = true;
 		m_buffSize++;
 		m_vectorSize++;
 	}
@@ -138,20 +170,22 @@ struct ColdVector {
 	void pop_back() {
 		if(m_vectorSize == 0) return;
 		m_vectorSize--;
+		// Keep the buffer from holding anything past the end
+		if((m_vectorSize >= m_buffIndex) && (m_vectorSize < (m_buffIndex + m_buffSize))) {
+			m_buffSize = m_vectorSize - m_buffIndex;
+		}
 	}
 
+	// The buffer may get written through the reference, so it has to go back to the file
 	T& operator[](std::size_t idx) {
-		if((idx < m_buffIndex) || (idx >= (m_buffIndex + m_buffSize))) {
-			dump_buffer();
-			load_buffer_at(idx);
-		}
-
-		return m_buffer[idx - m_buffIndex];
+		T& elem = element(idx);
+		m_dirty = true;
+		return elem;
 	}
 
-	T& operator[](std::size_t idx) const {
-		// I can't make this truly const :DDDDD
-		return const_cast<ColdVector *>(this)->operator[](idx);	
+	T const& operator[](std::size_t idx) const {
+		// Loading the buffer isn't truly const, reading from it leaves it clean
+		return const_cast<ColdVector *>(this)->element(idx);
 	}
 
 	void swap(ColdVector & other) noexcept {
@@ -162,6 +196,9 @@ struct ColdVector {
 		std::swap(m_fileName, other.m_fileName);
 		std::swap(m_fileOwner, other.m_fileOwner);
 		std::swap(m_fileStream, other.m_fileStream);
+		std::swap(m_fileOffset, other.m_fileOffset);
+		std::swap(m_dirty, other.m_dirty);
+		std::swap(m_borrowed, other.m_borrowed);
 	}
 
 	class iterator {
@@ -312,7 +349,10 @@ struct ColdVector {
 									  m_vectorSize{0},
 									  m_fileName{get_uuid()},
 									  m_fileOwner{true},
-									  m_fileStream{m_fileName, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc}
+									  m_fileStream{m_fileName, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc},
+									  m_fileOffset{0},
+									  m_dirty{false},
+									  m_borrowed{false}
 	{
 		for(auto it = begin; it < end; it++) {
 			emplace_back(*it);
@@ -334,11 +374,50 @@ struct ColdVector {
 	}
 
 private:
+	// Makes sure idx is in the buffer
+	T& element(std::size_t idx) {
+		if((idx < m_buffIndex) || (idx >= (m_buffIndex + m_buffSize))) {
+			dump_buffer();
+			load_buffer_at(idx);
+		}
+
+		return m_buffer[idx - m_buffIndex];
+	}
+
 	// dump_buffer is an internal thing to help deal with random file access.
+	// A buffer nothing was written to already matches the file.
 	void dump_buffer() {
-		if(m_buffSize == 0) return;
-		m_fileStream.seekp(m_buffIndex * sizeof(T), std::ios::beg);
+		if((m_buffSize == 0) || !m_dirty) return;
+		if(m_borrowed) {
+			detach();
+		}
+		m_fileStream.seekp(m_fileOffset + (m_buffIndex * sizeof(T)), std::ios::beg);
 		m_fileStream.write(reinterpret_cast<const char *>(&m_buffer), m_buffSize * sizeof(T));
+		m_dirty = false;
+	}
+
+	// Copies the elements out of a borrowed file into a file of our own
+	void detach() {
+		std::string fileName = get_uuid();
+		std::fstream own{fileName, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc};
+		std::array<char, 1 << 16> chunk;
+		std::size_t left = m_vectorSize * sizeof(T);
+		m_fileStream.clear();
+		m_fileStream.seekg(m_fileOffset, std::ios::beg);
+		while(left != 0) {
+			m_fileStream.read(chunk.data(), std::min(left, chunk.size()));
+			std::size_t got = m_fileStream.gcount();
+			// Anything past the end of the file has only ever been in the buffer
+			if(got == 0) break;
+			own.write(chunk.data(), got);
+			left -= got;
+		}
+		m_fileStream.close();
+		m_fileStream = std::move(own);
+		m_fileName = std::move(fileName);
+		m_fileOffset = 0;
+		m_fileOwner = true;
+		m_borrowed = false;
 	}
 
 	// Another helper for dealing with random file access.
@@ -353,10 +432,11 @@ private:
 		}
 		std::size_t new_idx = (idx / BUFF_SIZE) * BUFF_SIZE;
 
-		m_fileStream.seekg(new_idx * sizeof(T), std::ios::beg);
+		m_fileStream.seekg(m_fileOffset + (new_idx * sizeof(T)), std::ios::beg);
 		m_fileStream.read(reinterpret_cast<char*>(&m_buffer), std::min(BUFF_SIZE, (m_vectorSize - new_idx)) * sizeof(T));
 		m_buffIndex = new_idx;
 		m_buffSize = std::min((m_vectorSize - new_idx),BUFF_SIZE);
+		m_dirty = false;
 	}
 
 private:
@@ -367,6 +447,9 @@ private:
 	std::string				 m_fileName;	// The name of the file in which the data is stored
 	bool					 m_fileOwner;	// Check if this instance owns the file or not.
 	std::fstream			 m_fileStream;	// The filestream associated with the vector
+	std::size_t				 m_fileOffset;	// Bytes in front of the first element in the file
+	bool					 m_dirty;		// If the buffer holds writes the file doesn't have yet
+	bool					 m_borrowed;	// If the file belongs to someone else and must be copied before writing
 };
 #endif // COLD_VECTOR_H_6C4A5FE951FC4491A740E7D8F71E2E6B
 	
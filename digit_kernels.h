@@ -0,0 +1,828 @@
+/*
+ * File:      digit_kernels.h
+ * Author:    Daniel Hannon
+ *
+ * Copyright: 2024 Daniel Hannon
+ *
+ * Brief: Loops over little-endian digit arrays in any base up to 2^32,
+ * the ArbitraryBigNum counterpart of limb_kernels.h.
+ */
+
+#ifndef DIGIT_KERNELS_H_3A7E1C5B9D2F4A68B0C6E4D8F2A1B795
+#define DIGIT_KERNELS_H_3A7E1C5B9D2F4A68B0C6E4D8F2A1B795 1
+
+#include "limb_kernels.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+// The lazy partial products run four lanes per AVX2 register when the target has it (-mavx2)
+#if defined(__x86_64__) && defined(__AVX2__)
+#include <immintrin.h>
+#define DIGIT_KERNELS_AVX2 1
+#endif
+
+/*
+ * Every digit is below BASE. A BASE of 2^32 makes the digits plain binary
+ * limbs and each kernel hands over to its limb_kernels.h counterpart.
+ */
+
+template<std::uint64_t BASE>
+inline constexpr bool digit_is_binary = (BASE == ((std::uint64_t)1 << 32));
+
+// lhs + rhs + carry for two digits, carry becomes the carry out. A sum is
+// below 2 * BASE so one conditional subtract replaces the division.
+template<std::uint64_t BASE>
+constexpr std::uint32_t digit_add_carry(std::uint32_t lhs, std::uint32_t rhs, std::uint32_t& carry) {
+	std::uint64_t sum = (std::uint64_t)lhs + rhs + carry;
+	carry = (sum >= BASE);
+	return (sum - (carry ? BASE : 0)) & 0xFFFFFFFF;
+}
+
+// lhs - rhs - borrow for two digits, borrow becomes the borrow out
+template<std::uint64_t BASE>
+constexpr std::uint32_t digit_sub_borrow(std::uint32_t lhs, std::uint32_t rhs, std::uint32_t& borrow) {
+	std::uint64_t diff = (std::uint64_t)lhs - rhs - borrow;
+	// A wrapped subtraction sets the top bit
+	borrow = (diff >> 63) & 1;
+	return (diff + (borrow ? BASE : 0)) & 0xFFFFFFFF;
+}
+
+/*
+ * x / BASE for any 64 bit x as a multiply by a precomputed reciprocal and
+ * two shifts (Granlund and Montgomery, "Division by invariant integers using
+ * multiplication", figure 4.1). Power of two bases are a single shift.
+ */
+template<std::uint64_t BASE>
+constexpr std::uint64_t digit_div_base(std::uint64_t x) {
+	if constexpr((BASE & (BASE - 1)) == 0) {
+		return x >> std::countr_zero(BASE);
+	} else {
+#ifdef __SIZEOF_INT128__
+		using u128 = unsigned __int128;
+		// shift = ceil(log2(BASE)), magic = floor(2^64 (2^shift - BASE) / BASE) + 1
+		constexpr int shift = std::bit_width(BASE - 1);
+		constexpr std::uint64_t magic = (std::uint64_t)((((u128)1 << 64) * (((u128)1 << shift) - BASE)) / BASE) + 1;
+		std::uint64_t high = (std::uint64_t)(((u128)x * magic) >> 64);
+		return (high + ((x - high) >> 1)) >> (shift - 1);
+#else
+		return x / BASE;
+#endif
+	}
+}
+
+// Returns x / BASE and leaves x % BASE in digit
+template<std::uint64_t BASE>
+constexpr std::uint64_t digit_split(std::uint64_t x, std::uint32_t& digit) {
+	std::uint64_t quot = digit_div_base<BASE>(x);
+	digit = (x - (quot * BASE)) & 0xFFFFFFFF;
+	return quot;
+}
+
+// res = lhs + rhs over n digits, returns the carry out. res may alias either input.
+template<std::uint64_t BASE>
+constexpr std::uint32_t digit_add_n(std::uint32_t* res, std::uint32_t const* lhs, std::uint32_t const* rhs, std::size_t n) {
+	if constexpr(digit_is_binary<BASE>) {
+		return limb_add_n(res, lhs, rhs, n);
+	} else {
+		std::uint32_t carry = 0;
+		for(std::size_t idx = 0; idx < n; idx++) {
+			res[idx] = digit_add_carry<BASE>(lhs[idx], rhs[idx], carry);
+		}
+		return carry;
+	}
+}
+
+// res = lhs - rhs over n digits, returns the borrow out. res may alias either input.
+template<std::uint64_t BASE>
+constexpr std::uint32_t digit_sub_n(std::uint32_t* res, std::uint32_t const* lhs, std::uint32_t const* rhs, std::size_t n) {
+	if constexpr(digit_is_binary<BASE>) {
+		return limb_sub_n(res, lhs, rhs, n);
+	} else {
+		std::uint32_t borrow = 0;
+		for(std::size_t idx = 0; idx < n; idx++) {
+			res[idx] = digit_sub_borrow<BASE>(lhs[idx], rhs[idx], borrow);
+		}
+		return borrow;
+	}
+}
+
+// Adds val < BASE at data[0] and ripples the carry through len digits, returns the carry out of the top.
+template<std::uint64_t BASE>
+constexpr std::uint32_t digit_add_1(std::uint32_t* data, std::size_t len, std::uint32_t val) {
+	if constexpr(digit_is_binary<BASE>) {
+		return limb_add_1(data, len, val);
+	} else {
+		std::uint32_t carry = 0;
+		for(std::size_t idx = 0; (idx < len) && (val != 0); idx++) {
+			data[idx] = digit_add_carry<BASE>(data[idx], val, carry);
+			val = carry;
+			carry = 0;
+		}
+		return val;
+	}
+}
+
+// data = data * mult, returns the digit that carried out of the top
+template<std::uint64_t BASE>
+constexpr std::uint32_t digit_mul_1(std::uint32_t* data, std::size_t len, std::uint32_t mult) {
+	if constexpr(digit_is_binary<BASE>) {
+		return limb_mul_1_add(data, len, mult, 0);
+	} else {
+		std::uint64_t carry = 0;
+		for(std::size_t idx = 0; idx < len; idx++) {
+			carry = digit_split<BASE>(carry + ((std::uint64_t)data[idx] * mult), data[idx]);
+		}
+		return carry & 0xFFFFFFFF;
+	}
+}
+
+// data = data / div in a single pass from the top digit down, returns data % div.
+template<std::uint64_t BASE>
+constexpr std::uint32_t digit_divmod_1(std::uint32_t* data, std::size_t len, std::uint32_t div) {
+	if constexpr(digit_is_binary<BASE>) {
+		return limb_divmod_1(data, len, div);
+	} else {
+		std::uint64_t rem = 0;
+		for(std::size_t idx = len; idx > 0; idx--) {
+			rem = (rem * BASE) + data[idx - 1];
+			data[idx - 1] = (rem / div) & 0xFFFFFFFF;
+			rem %= div;
+		}
+		return rem & 0xFFFFFFFF;
+	}
+}
+
+// Compares two n digit numbers, returns -1, 0 or 1
+constexpr int digit_cmp_n(std::uint32_t const* lhs, std::uint32_t const* rhs, std::size_t n) {
+	for(std::size_t idx = n; idx > 0; idx--) {
+		if(lhs[idx - 1] != rhs[idx - 1]) {
+			return (lhs[idx - 1] < rhs[idx - 1]) ? -1 : 1;
+		}
+	}
+	return 0;
+}
+
+// Adds the len digits at data into res[off..total) and ripples the carry to the top.
+// The digits of data that land past total must be zero.
+template<std::uint64_t BASE>
+constexpr void digit_add_at(std::uint32_t* res, std::size_t total, std::size_t off, std::uint32_t const* data, std::size_t len) {
+	if(off >= total) return;
+	len = std::min(len, total - off);
+	auto carry = digit_add_n<BASE>(res + off, res + off, data, len);
+	digit_add_1<BASE>(res + off + len, total - off - len, carry);
+}
+
+// res = lhs + rhs for signed n digit magnitudes, returns whether res is negative.
+// The result has to fit in n digits. res may alias either input.
+template<std::uint64_t BASE>
+constexpr bool digit_add_signed(std::uint32_t* res, std::uint32_t const* lhs, bool lhsNeg, std::uint32_t const* rhs, bool rhsNeg, std::size_t n) {
+	if(lhsNeg == rhsNeg) {
+		digit_add_n<BASE>(res, lhs, rhs, n);
+		return lhsNeg;
+	}
+	if(digit_cmp_n(lhs, rhs, n) >= 0) {
+		digit_sub_n<BASE>(res, lhs, rhs, n);
+		return lhsNeg;
+	}
+	digit_sub_n<BASE>(res, rhs, lhs, n);
+	return rhsNeg;
+}
+
+/*
+ * Rows of partial products that can be summed into 64 bit lanes before the
+ * carries have to be settled. A lane starts below BASE, gains less than
+ * (BASE - 1)^2 per row and still has to take the carry from the lane below.
+ * Base 10^9 gets 18 rows, bases close to 2^32 only one.
+ */
+template<std::uint64_t BASE>
+inline constexpr std::size_t digit_lazy_rows = (UINT64_MAX - (BASE - 1) - (UINT64_MAX / BASE)) / ((BASE - 1) * (BASE - 1));
+
+// Adds rows partial products into lanes[0..len+rows) without carrying them
+template<std::uint64_t BASE>
+constexpr void digit_addmul_lazy(std::uint64_t* lanes, std::uint32_t const* lhs, std::size_t len, std::uint32_t const* rhs, std::size_t rows) {
+	for(std::size_t row = 0; row < rows; row++) {
+		std::uint64_t mult = rhs[row];
+		std::size_t idx = 0;
+#ifdef DIGIT_KERNELS_AVX2
+		if(!std::is_constant_evaluated()) {
+			// VPMULUDQ multiplies the low 32 bits of each 64 bit lane
+			__m256i wide = _mm256_set1_epi64x((long long)mult);
+			for(; (idx + 4) <= len; idx += 4) {
+				__m256i digits = _mm256_cvtepu32_epi64(_mm_loadu_si128(reinterpret_cast<__m128i const*>(lhs + idx)));
+				auto* at = reinterpret_cast<__m256i*>(lanes + row + idx);
+				_mm256_storeu_si256(at, _mm256_add_epi64(_mm256_loadu_si256(at), _mm256_mul_epu32(digits, wide)));
+			}
+		}
+#endif
+		for(; idx < len; idx++) {
+			lanes[row + idx] += lhs[idx] * mult;
+		}
+	}
+}
+
+// Carries len lanes into digits at res, returns what carried out of the top
+template<std::uint64_t BASE>
+constexpr std::uint64_t digit_normalize_lanes(std::uint32_t* res, std::uint64_t const* lanes, std::size_t len) {
+	std::uint64_t carry = 0;
+	for(std::size_t idx = 0; idx < len; idx++) {
+		carry = digit_split<BASE>(lanes[idx] + carry, res[idx]);
+	}
+	return carry;
+}
+
+// res[0..lhsLen+rhsLen) = lhs * rhs, res must not alias either input.
+// Outside binary the carries are only settled every digit_lazy_rows rows.
+template<std::uint64_t BASE>
+constexpr void digit_mul_basecase(std::uint32_t* res, std::uint32_t const* lhs, std::size_t lhsLen, std::uint32_t const* rhs, std::size_t rhsLen) {
+	if constexpr(digit_is_binary<BASE>) {
+		limb_mul_basecase(res, lhs, lhsLen, rhs, rhsLen);
+	} else {
+		constexpr std::size_t rows = digit_lazy_rows<BASE>;
+		static_assert(rows != 0, "Every base below 2^32 can take at least one row");
+		std::fill(res, res + lhsLen + rhsLen, 0);
+		auto mul = [&](std::uint64_t* lanes) {
+			for(std::size_t first = 0; first < rhsLen; first += rows) {
+				std::size_t count = std::min(rows, rhsLen - first);
+				// Lanes start from the digits already settled, the block then fits in lhsLen + count digits
+				std::copy(res + first, res + first + lhsLen + count, lanes);
+				digit_addmul_lazy<BASE>(lanes, lhs, lhsLen, rhs + first, count);
+				digit_normalize_lanes<BASE>(res + first, lanes, lhsLen + count);
+			}
+		};
+		// Leaves of the recursive products are short enough for the stack
+		std::size_t width = lhsLen + std::min(rows, rhsLen);
+		if(width <= 128) {
+			std::array<std::uint64_t, 128> lanes;
+			mul(lanes.data());
+		} else {
+			std::vector<std::uint64_t> lanes(width);
+			mul(lanes.data());
+		}
+	}
+}
+
+/*
+ * DigitAccumulator is the opt-in lazy mode for long runs of additions and
+ * products in one base. Terms go into 64 bit lanes, one per digit, and the
+ * carries are only settled when a lane could overflow or the sum is asked
+ * for. In base 10^9 that is thousands of millions of digit additions or 18
+ * product rows between normalizations. Every term is a magnitude.
+ */
+template<std::uint64_t BASE>
+struct DigitAccumulator {
+	DigitAccumulator() : m_lanes{}, m_pending{0}
+	{}
+
+	// this += the len digits at data
+	DigitAccumulator& add(std::uint32_t const* data, std::size_t len) {
+		reserve(len, BASE - 1);
+		for(std::size_t idx = 0; idx < len; idx++) {
+			m_lanes[idx] += data[idx];
+		}
+		return *this;
+	}
+
+	// this += lhs * rhs, the partial products are never carried on their own
+	DigitAccumulator& addmul(std::uint32_t const* lhs, std::size_t lhsLen, std::uint32_t const* rhs, std::size_t rhsLen) {
+		constexpr std::size_t rows = digit_lazy_rows<BASE>;
+		for(std::size_t first = 0; first < rhsLen; first += rows) {
+			std::size_t count = std::min(rows, rhsLen - first);
+			reserve(first + lhsLen + count, count * (BASE - 1) * (BASE - 1));
+			digit_addmul_lazy<BASE>(m_lanes.data() + first, lhs, lhsLen, rhs + first, count);
+		}
+		return *this;
+	}
+
+	// Settles the deferred carries, after this every lane holds a single digit
+	void normalize() {
+		std::vector<std::uint32_t> digits(m_lanes.size());
+		std::uint64_t carry = digit_normalize_lanes<BASE>(digits.data(), m_lanes.data(), m_lanes.size());
+		std::copy(digits.begin(), digits.end(), m_lanes.begin());
+		while(carry != 0) {
+			std::uint32_t digit;
+			carry = digit_split<BASE>(carry, digit);
+			m_lanes.push_back(digit);
+		}
+		m_pending = BASE - 1;
+	}
+
+	// The settled sum as little-endian digits without leading zeroes, zero is a single digit
+	std::vector<std::uint32_t> result() const {
+		DigitAccumulator temp{*this};
+		temp.normalize();
+		std::vector<std::uint32_t> digits(temp.m_lanes.begin(), temp.m_lanes.end());
+		while((digits.size() > 1) && (digits.back() == 0)) {
+			digits.pop_back();
+		}
+		if(digits.empty()) {
+			digits.push_back(0);
+		}
+		return digits;
+	}
+
+private:
+	// Grows the lanes to len and normalizes first if adding up to most to a lane could overflow it
+	void reserve(std::size_t len, std::uint64_t most) {
+		if(m_lanes.size() < len) {
+			m_lanes.resize(len, 0);
+		}
+		if(most > (sc_maxPending - m_pending)) {
+			normalize();
+		}
+		m_pending += most;
+	}
+
+private:
+	// Leaves room for the carry coming in from the lane below, as digit_lazy_rows does
+	static constexpr std::uint64_t sc_maxPending = UINT64_MAX - (UINT64_MAX / BASE);
+
+	std::vector<std::uint64_t> m_lanes;	  // One lane per digit of the sum
+	std::uint64_t			   m_pending; // Upper bound on the value of any lane
+};
+
+/*
+ * Thresholds in digits a side for the recursive products. The binary
+ * basecase runs on 64 bit words, the other bases sum 64 bit lanes that only
+ * get carried every few rows and end up splitting later.
+ */
+template<std::uint64_t BASE>
+inline constexpr std::size_t digit_karatsuba_limbs = digit_is_binary<BASE> ? 48 : 96;
+
+template<std::uint64_t BASE>
+inline constexpr std::size_t digit_toom3_limbs = digit_is_binary<BASE> ? 144 : 288;
+
+// Extra digits a Toom-3 evaluation needs on top of a piece, enough to hold 8 * BASE^k
+template<std::uint64_t BASE>
+inline constexpr std::size_t digit_toom3_headroom = (BASE >= 8) ? 1 : ((BASE >= 3) ? 2 : 3);
+
+// Scratch digits digit_mul_n needs for an n digit product
+template<std::uint64_t BASE>
+constexpr std::size_t digit_mul_scratch(std::size_t n) {
+	if(n < digit_karatsuba_limbs<BASE>) {
+		return 0;
+	}
+	if(n < digit_toom3_limbs<BASE>) {
+		std::size_t high = n - (n / 2);
+		return (6 * high) + 1 + digit_mul_scratch<BASE>(high);
+	}
+	std::size_t eval = ((n + 2) / 3) + digit_toom3_headroom<BASE>;
+	return (19 * eval) + digit_mul_scratch<BASE>(eval);
+}
+
+template<std::uint64_t BASE>
+constexpr void digit_mul_n(std::uint32_t* res, std::uint32_t const* lhs, std::uint32_t const* rhs, std::size_t n, std::uint32_t* scratch);
+
+/*
+ * res[0..2n) = lhs * rhs for two n digit numbers by Karatsuba. The middle
+ * term is taken as l0 r0 + l1 r1 - (l1 - l0)(r1 - r0) so both factors of
+ * the third product stay n / 2 digits, the signs of the differences are
+ * tracked on the side.
+ */
+template<std::uint64_t BASE>
+constexpr void digit_mul_karatsuba(std::uint32_t* res, std::uint32_t const* lhs, std::uint32_t const* rhs, std::size_t n, std::uint32_t* scratch) {
+	// Low halves have low digits, high halves the remaining high >= low digits
+	std::size_t low = n / 2;
+	std::size_t high = n - low;
+	digit_mul_n<BASE>(res, lhs, rhs, low, scratch);
+	digit_mul_n<BASE>(res + (2 * low), lhs + low, rhs + low, high, scratch);
+
+	std::uint32_t* lhsDiff = scratch;
+	std::uint32_t* rhsDiff = scratch + high;
+	std::uint32_t* middle = scratch + (2 * high);
+	std::uint32_t* product = scratch + (4 * high) + 1;
+	std::fill(lhsDiff, lhsDiff + (2 * high), 0);
+	std::copy(lhs, lhs + low, lhsDiff);
+	std::copy(rhs, rhs + low, rhsDiff);
+	bool lhsNeg = digit_add_signed<BASE>(lhsDiff, lhs + low, false, lhsDiff, true, high);
+	bool rhsNeg = digit_add_signed<BASE>(rhsDiff, rhs + low, false, rhsDiff, true, high);
+	digit_mul_n<BASE>(product, lhsDiff, rhsDiff, high, scratch + (6 * high) + 1);
+
+	// middle = l0 r0 + l1 r1 -+ |l1 - l0| |r1 - r0|, never negative
+	std::fill(middle, middle + (2 * high) + 1, 0);
+	std::copy(res, res + (2 * low), middle);
+	digit_add_at<BASE>(middle, (2 * high) + 1, 0, res + (2 * low), 2 * high);
+	if(lhsNeg == rhsNeg) {
+		auto borrow = digit_sub_n<BASE>(middle, middle, product, 2 * high);
+		middle[2 * high] -= borrow;
+	} else {
+		digit_add_at<BASE>(middle, (2 * high) + 1, 0, product, 2 * high);
+	}
+	digit_add_at<BASE>(res, 2 * n, low, middle, (2 * high) + 1);
+}
+
+/*
+ * res[0..2n) = lhs * rhs for two n digit numbers by Toom-3. Each side is cut
+ * into three pieces of k digits, evaluated at 0, 1, -1, -2 and infinity,
+ * the five products are interpolated back with Bodrato's sequence. Values at
+ * the negative points keep their sign on the side, the magnitudes are carried
+ * with enough headroom that no step can overflow.
+ */
+template<std::uint64_t BASE>
+constexpr void digit_mul_toom3(std::uint32_t* res, std::uint32_t const* lhs, std::uint32_t const* rhs, std::size_t n, std::uint32_t* scratch) {
+	std::size_t k = (n + 2) / 3;
+	std::size_t top = n - (2 * k);
+	std::size_t eval = k + digit_toom3_headroom<BASE>;
+	std::size_t wide = 2 * eval;
+
+	std::uint32_t* pad = scratch;
+	std::uint32_t* lhsOne = pad + eval;
+	std::uint32_t* lhsNegOne = lhsOne + eval;
+	std::uint32_t* lhsNegTwo = lhsNegOne + eval;
+	std::uint32_t* rhsOne = lhsNegTwo + eval;
+	std::uint32_t* rhsNegOne = rhsOne + eval;
+	std::uint32_t* rhsNegTwo = rhsNegOne + eval;
+	std::uint32_t* prodOne = rhsNegTwo + eval;
+	std::uint32_t* prodNegOne = prodOne + wide;
+	std::uint32_t* prodNegTwo = prodNegOne + wide;
+	std::uint32_t* zero = prodNegTwo + wide;
+	std::uint32_t* inf = zero + wide;
+	std::uint32_t* temp = inf + wide;
+	std::uint32_t* next = temp + wide;
+
+	// Copies len digits into an eval digit buffer padded with zeroes
+	auto widen = [&](std::uint32_t* out, std::uint32_t const* data, std::size_t len, std::size_t width) {
+		std::copy(data, data + len, out);
+		std::fill(out + len, out + width, 0);
+	};
+	// Fills the value at 1, -1 and -2 of the three pieces at data, returns the signs at -1 and -2
+	auto evaluate = [&](std::uint32_t const* data, std::uint32_t* one, std::uint32_t* negOne, std::uint32_t* negTwo) {
+		// one = p0 + p2, then p0 + p1 + p2 and negOne = p0 - p1 + p2
+		widen(one, data, k, eval);
+		digit_add_at<BASE>(one, eval, 0, data + (2 * k), top);
+		widen(pad, data + k, k, eval);
+		bool negOneSign = digit_add_signed<BASE>(negOne, one, false, pad, true, eval);
+		digit_add_n<BASE>(one, one, pad, eval);
+		// negTwo = 2 (p(-1) + p2) - p0 = p0 - 2 p1 + 4 p2
+		widen(pad, data + (2 * k), top, eval);
+		bool negTwoSign = digit_add_signed<BASE>(negTwo, negOne, negOneSign, pad, false, eval);
+		digit_mul_1<BASE>(negTwo, eval, 2);
+		widen(pad, data, k, eval);
+		negTwoSign = digit_add_signed<BASE>(negTwo, negTwo, negTwoSign, pad, true, eval);
+		return std::pair<bool, bool>{negOneSign, negTwoSign};
+	};
+	auto [lhsNegOneSign, lhsNegTwoSign] = evaluate(lhs, lhsOne, lhsNegOne, lhsNegTwo);
+	auto [rhsNegOneSign, rhsNegTwoSign] = evaluate(rhs, rhsOne, rhsNegOne, rhsNegTwo);
+
+	// r(0) and r(inf) go straight into place, the rest is added on top of them
+	digit_mul_n<BASE>(res, lhs, rhs, k, next);
+	digit_mul_n<BASE>(res + (4 * k), lhs + (2 * k), rhs + (2 * k), top, next);
+	std::fill(res + (2 * k), res + (4 * k), 0);
+	widen(zero, res, 2 * k, wide);
+	widen(inf, res + (4 * k), 2 * top, wide);
+	digit_mul_n<BASE>(prodOne, lhsOne, rhsOne, eval, next);
+	digit_mul_n<BASE>(prodNegOne, lhsNegOne, rhsNegOne, eval, next);
+	digit_mul_n<BASE>(prodNegTwo, lhsNegTwo, rhsNegTwo, eval, next);
+	bool negOneSign = (lhsNegOneSign != rhsNegOneSign);
+	bool negTwoSign = (lhsNegTwoSign != rhsNegTwoSign);
+
+	// r3 = (r(-2) - r(1)) / 3
+	std::uint32_t* r3 = prodNegTwo;
+	bool r3Sign = digit_add_signed<BASE>(r3, prodNegTwo, negTwoSign, prodOne, true, wide);
+	digit_divmod_1<BASE>(r3, wide, 3);
+	// r1 = (r(1) - r(-1)) / 2
+	std::uint32_t* r1 = prodOne;
+	bool r1Sign = digit_add_signed<BASE>(r1, prodOne, false, prodNegOne, !negOneSign, wide);
+	digit_divmod_1<BASE>(r1, wide, 2);
+	// r2 = r(-1) - r(0)
+	std::uint32_t* r2 = prodNegOne;
+	bool r2Sign = digit_add_signed<BASE>(r2, prodNegOne, negOneSign, zero, true, wide);
+	// r3 = (r2 - r3) / 2 + 2 r(inf)
+	r3Sign = digit_add_signed<BASE>(r3, r2, r2Sign, r3, !r3Sign, wide);
+	digit_divmod_1<BASE>(r3, wide, 2);
+	std::copy(inf, inf + wide, temp);
+	digit_mul_1<BASE>(temp, wide, 2);
+	r3Sign = digit_add_signed<BASE>(r3, r3, r3Sign, temp, false, wide);
+	// r2 = r2 + r1 - r(inf)
+	r2Sign = digit_add_signed<BASE>(r2, r2, r2Sign, r1, r1Sign, wide);
+	r2Sign = digit_add_signed<BASE>(r2, r2, r2Sign, inf, true, wide);
+	// r1 = r1 - r3
+	r1Sign = digit_add_signed<BASE>(r1, r1, r1Sign, r3, !r3Sign, wide);
+
+	// The remaining coefficients are never negative
+	digit_add_at<BASE>(res, 2 * n, k, r1, wide);
+	digit_add_at<BASE>(res, 2 * n, 2 * k, r2, wide);
+	digit_add_at<BASE>(res, 2 * n, 3 * k, r3, wide);
+}
+
+// res[0..2n) = lhs * rhs for two n digit numbers, scratch needs digit_mul_scratch(n) digits
+template<std::uint64_t BASE>
+constexpr void digit_mul_n(std::uint32_t* res, std::uint32_t const* lhs, std::uint32_t const* rhs, std::size_t n, std::uint32_t* scratch) {
+	if(n < digit_karatsuba_limbs<BASE>) {
+		digit_mul_basecase<BASE>(res, lhs, n, rhs, n);
+	} else if(n < digit_toom3_limbs<BASE>) {
+		digit_mul_karatsuba<BASE>(res, lhs, rhs, n, scratch);
+	} else {
+		digit_mul_toom3<BASE>(res, lhs, rhs, n, scratch);
+	}
+}
+
+// res[0..lhsLen+rhsLen) = lhs * rhs for any lengths, res must not alias either input.
+// Uneven operands are multiplied a block of the shorter length at a time.
+template<std::uint64_t BASE>
+constexpr void digit_mul(std::uint32_t* res, std::uint32_t const* lhs, std::size_t lhsLen, std::uint32_t const* rhs, std::size_t rhsLen) {
+	if(lhsLen < rhsLen) {
+		std::swap(lhs, rhs);
+		std::swap(lhsLen, rhsLen);
+	}
+	if(rhsLen < digit_karatsuba_limbs<BASE>) {
+		digit_mul_basecase<BASE>(res, lhs, lhsLen, rhs, rhsLen);
+		return;
+	}
+	std::vector<std::uint32_t> scratch(digit_mul_scratch<BASE>(rhsLen));
+	if(lhsLen == rhsLen) {
+		digit_mul_n<BASE>(res, lhs, rhs, rhsLen, scratch.data());
+		return;
+	}
+	std::fill(res, res + lhsLen + rhsLen, 0);
+	std::vector<std::uint32_t> block(2 * rhsLen);
+	for(std::size_t off = 0; off < lhsLen; off += rhsLen) {
+		std::size_t len = std::min(rhsLen, lhsLen - off);
+		if(len == rhsLen) {
+			digit_mul_n<BASE>(block.data(), lhs + off, rhs, rhsLen, scratch.data());
+		} else {
+			digit_mul<BASE>(block.data(), rhs, rhsLen, lhs + off, len);
+		}
+		digit_add_at<BASE>(res, lhsLen + rhsLen, off, block.data(), rhsLen + len);
+	}
+}
+
+// res -= data * mult over n digits, returns the digit that borrowed out of the top.
+template<std::uint64_t BASE>
+constexpr std::uint32_t digit_submul_1(std::uint32_t* res, std::uint32_t const* data, std::size_t n, std::uint32_t mult) {
+	if constexpr(digit_is_binary<BASE>) {
+		return limb_submul_1(res, data, n, mult);
+	} else {
+		std::uint64_t carry = 0;
+		for(std::size_t idx = 0; idx < n; idx++) {
+			std::uint32_t low = 0;
+			std::uint32_t borrow = 0;
+			carry = digit_split<BASE>(((std::uint64_t)data[idx] * mult) + carry, low);
+			res[idx] = digit_sub_borrow<BASE>(res[idx], low, borrow);
+			carry += borrow;
+		}
+		return carry & 0xFFFFFFFF;
+	}
+}
+
+/*
+ * Knuth's algorithm D in any base. quot[0..numLen-divLen] gets num / div and
+ * num[0..divLen) is left holding the remainder. num needs room for
+ * numLen + 1 digits, div is normalized in place and put back afterwards.
+ * div[divLen - 1] must be non-zero and numLen >= divLen.
+ *
+ * Binary uses limb_divmod_n, which normalizes with a shift. Other bases
+ * scale both sides by BASE / (top + 1) so the top digit of div is at least
+ * BASE / 2, which keeps every trial quotient within 2 of the real one.
+ */
+template<std::uint64_t BASE>
+constexpr void digit_divmod_n(std::uint32_t* quot, std::uint32_t* num, std::size_t numLen, std::uint32_t* div, std::size_t divLen) {
+	if constexpr(digit_is_binary<BASE>) {
+		limb_divmod_n(quot, num, numLen, div, divLen);
+	} else {
+		if(divLen == 1) {
+			std::copy_n(num, numLen, quot);
+			num[0] = digit_divmod_1<BASE>(quot, numLen, div[0]);
+			return;
+		}
+		std::uint32_t scale = (BASE / ((std::uint64_t)div[divLen - 1] + 1)) & 0xFFFFFFFF;
+		digit_mul_1<BASE>(div, divLen, scale);
+		num[numLen] = digit_mul_1<BASE>(num, numLen, scale);
+		std::uint64_t top = div[divLen - 1];
+		std::uint64_t next = div[divLen - 2];
+		for(std::size_t idx = numLen - divLen + 1; idx > 0; idx--) {
+			std::size_t pos = idx - 1;
+			std::uint64_t head = ((std::uint64_t)num[pos + divLen] * BASE) + num[pos + divLen - 1];
+			std::uint64_t qhat = head / top;
+			std::uint64_t rhat = head % top;
+			while((qhat >= BASE) || ((qhat * next) > ((rhat * BASE) + num[pos + divLen - 2]))) {
+				qhat--;
+				rhat += top;
+				if(rhat >= BASE) break;
+			}
+			auto borrow = digit_submul_1<BASE>(num + pos, div, divLen, qhat & 0xFFFFFFFF);
+			std::int64_t diff = (std::int64_t)num[pos + divLen] - borrow;
+			// Went one too far, add div back
+			if(diff < 0) {
+				qhat--;
+				diff += digit_add_n<BASE>(num + pos, num + pos, div, divLen);
+			}
+			num[pos + divLen] = diff & 0xFFFFFFFF;
+			quot[pos] = qhat & 0xFFFFFFFF;
+		}
+		digit_divmod_1<BASE>(num, divLen, scale);
+		digit_divmod_1<BASE>(div, divLen, scale);
+	}
+}
+
+// Binary limbs below which digit_from_limbs peels digits off one chunk at a time
+template<std::uint64_t BASE>
+inline constexpr std::size_t digit_radix_limbs = 24;
+
+// Digits of BASE that fit in one binary limb, and BASE to that power
+template<std::uint64_t BASE>
+inline constexpr std::size_t digit_chunk_digits = []() {
+	std::size_t digits = 1;
+	for(std::uint64_t chunk = BASE; chunk <= (UINT32_MAX / BASE); chunk *= BASE) {
+		digits++;
+	}
+	return digits;
+}();
+
+template<std::uint64_t BASE>
+inline constexpr std::uint64_t digit_chunk_value = []() {
+	std::uint64_t chunk = 1;
+	for(std::size_t idx = 0; idx < digit_chunk_digits<BASE>; idx++) {
+		chunk *= BASE;
+	}
+	return chunk;
+}();
+
+// Upper bound on the digits len binary limbs turn into
+template<std::uint64_t BASE>
+constexpr std::size_t digit_from_limbs_bound(std::size_t len) {
+	std::size_t bits = std::bit_width(BASE) - 1;
+	return (((32 * len) + bits - 1) / bits) + 1;
+}
+
+// out = the len binary limbs at limbs in base BASE by repeated single limb
+// division, returns the digit count without leading zeroes
+template<std::uint64_t BASE>
+std::size_t digit_from_limbs_basecase(std::uint32_t* out, std::uint32_t const* limbs, std::size_t len) {
+	len = limb_active_length(limbs, len);
+	if constexpr(digit_is_binary<BASE>) {
+		std::copy_n(limbs, len, out);
+		return len;
+	} else {
+		std::vector<std::uint32_t> scratch{limbs, limbs + len};
+		std::size_t count = 0;
+		while(len != 0) {
+			std::uint32_t chunk = limb_divmod_1(scratch.data(), len, digit_chunk_value<BASE> & 0xFFFFFFFF);
+			len = limb_active_length(scratch.data(), len);
+			for(std::size_t idx = 0; (idx < digit_chunk_digits<BASE>) && ((len != 0) || (chunk != 0)); idx++) {
+				out[count++] = chunk % BASE;
+				chunk /= BASE;
+			}
+		}
+		return count;
+	}
+}
+
+template<std::uint64_t BASE>
+std::size_t digit_from_limbs_rec(std::uint32_t* out, std::uint32_t const* limbs, std::size_t len, std::vector<std::vector<std::uint32_t>> const& powers) {
+	len = limb_active_length(limbs, len);
+	if(len < digit_radix_limbs<BASE>) {
+		return digit_from_limbs_basecase<BASE>(out, limbs, len);
+	}
+	// limbs = hi * (2^32)^k + lo with k the largest power of two below len
+	std::size_t level = std::bit_width(len - 1) - 1;
+	std::size_t k = (std::size_t)1 << level;
+	auto const& power = powers[level];
+	std::vector<std::uint32_t> hi(digit_from_limbs_bound<BASE>(len - k));
+	std::vector<std::uint32_t> lo(digit_from_limbs_bound<BASE>(k));
+	std::size_t hiLen = digit_from_limbs_rec<BASE>(hi.data(), limbs + k, len - k, powers);
+	std::size_t loLen = digit_from_limbs_rec<BASE>(lo.data(), limbs, k, powers);
+	// lo is below power so it fits in the bottom of the product
+	std::vector<std::uint32_t> product(hiLen + power.size(), 0);
+	digit_mul<BASE>(product.data(), hi.data(), hiLen, power.data(), power.size());
+	digit_add_at<BASE>(product.data(), product.size(), 0, lo.data(), loLen);
+	std::size_t count = limb_active_length(product.data(), product.size());
+	std::copy_n(product.data(), count, out);
+	return count;
+}
+
+/*
+ * out = the len binary limbs at limbs in base BASE, returns the digit count
+ * without leading zeroes, 0 for 0. out needs digit_from_limbs_bound(len) digits.
+ * Long inputs are split in half as hi * (2^32)^k + lo, both halves converted
+ * recursively and joined with one product by (2^32)^k already in base BASE,
+ * so the conversion runs at the speed of digit_mul instead of quadratically.
+ */
+template<std::uint64_t BASE>
+std::size_t digit_from_limbs(std::uint32_t* out, std::uint32_t const* limbs, std::size_t len) {
+	len = limb_active_length(limbs, len);
+	if constexpr(digit_is_binary<BASE>) {
+		std::copy_n(limbs, len, out);
+		return len;
+	} else {
+		if(len < digit_radix_limbs<BASE>) {
+			return digit_from_limbs_basecase<BASE>(out, limbs, len);
+		}
+		// powers[j] = (2^32)^(2^j) in base BASE
+		std::vector<std::vector<std::uint32_t>> powers;
+		std::array<std::uint32_t, 2> radix{0, 1};
+		powers.emplace_back(digit_from_limbs_bound<BASE>(2));
+		powers.back().resize(digit_from_limbs_basecase<BASE>(powers.back().data(), radix.data(), 2));
+		while(((std::size_t)2 << (powers.size() - 1)) < len) {
+			auto const& last = powers.back();
+			std::vector<std::uint32_t> square(2 * last.size(), 0);
+			digit_mul<BASE>(square.data(), last.data(), last.size(), last.data(), last.size());
+			square.resize(limb_active_length(square.data(), square.size()));
+			powers.emplace_back(std::move(square));
+		}
+		return digit_from_limbs_rec<BASE>(out, limbs, len, powers);
+	}
+}
+
+// Upper bound on the binary limbs len digits of BASE turn into
+template<std::uint64_t BASE>
+constexpr std::size_t digit_to_limbs_bound(std::size_t len) {
+	std::size_t bits = std::bit_width(BASE - 1);
+	return (((bits * len) + 31) / 32) + 1;
+}
+
+// out = the len digits at digits as binary limbs by Horner's rule, a binary
+// limb's worth of digits at a time, returns the limb count without leading zeroes
+template<std::uint64_t BASE>
+std::size_t digit_to_limbs_basecase(std::uint32_t* out, std::uint32_t const* digits, std::size_t len) {
+	if constexpr(digit_is_binary<BASE>) {
+		len = limb_active_length(digits, len);
+		std::copy_n(digits, len, out);
+		return len;
+	} else {
+		std::size_t active = 0;
+		std::uint64_t chunk = 0;
+		std::uint64_t scale = 1;
+		auto flush = [&]() {
+			auto carry = limb_mul_1_add(out, active, scale & 0xFFFFFFFF, chunk & 0xFFFFFFFF);
+			if(carry != 0) {
+				out[active++] = carry;
+			}
+			chunk = 0;
+			scale = 1;
+		};
+		for(std::size_t idx = len; idx > 0; idx--) {
+			chunk = (chunk * BASE) + digits[idx - 1];
+			scale *= BASE;
+			if(scale == digit_chunk_value<BASE>) {
+				flush();
+			}
+		}
+		if(scale != 1) {
+			flush();
+		}
+		return active;
+	}
+}
+
+template<std::uint64_t BASE>
+std::size_t digit_to_limbs_rec(std::uint32_t* out, std::uint32_t const* digits, std::size_t len, std::vector<std::vector<std::uint32_t>> const& powers) {
+	len = limb_active_length(digits, len);
+	if(len < digit_radix_limbs<BASE>) {
+		return digit_to_limbs_basecase<BASE>(out, digits, len);
+	}
+	// digits = hi * BASE^k + lo with k the largest power of two below len
+	std::size_t level = std::bit_width(len - 1) - 1;
+	std::size_t k = (std::size_t)1 << level;
+	auto const& power = powers[level];
+	std::vector<std::uint32_t> hi(digit_to_limbs_bound<BASE>(len - k));
+	std::vector<std::uint32_t> lo(digit_to_limbs_bound<BASE>(k));
+	std::size_t hiLen = digit_to_limbs_rec<BASE>(hi.data(), digits + k, len - k, powers);
+	std::size_t loLen = digit_to_limbs_rec<BASE>(lo.data(), digits, k, powers);
+	std::vector<std::uint32_t> product(std::max(hiLen + power.size(), loLen) + 1, 0);
+	if(hiLen != 0) {
+		digit_mul<(std::uint64_t)1 << 32>(product.data(), hi.data(), hiLen, power.data(), power.size());
+	}
+	digit_add_at<(std::uint64_t)1 << 32>(product.data(), product.size(), 0, lo.data(), loLen);
+	std::size_t count = limb_active_length(product.data(), product.size());
+	std::copy_n(product.data(), count, out);
+	return count;
+}
+
+/*
+ * out = the len digits of BASE at digits as binary limbs, returns the limb
+ * count without leading zeroes, 0 for 0. out needs digit_to_limbs_bound(len)
+ * limbs. The inverse of digit_from_limbs: long inputs are split as
+ * hi * BASE^k + lo and joined with one binary product by BASE^k.
+ */
+template<std::uint64_t BASE>
+std::size_t digit_to_limbs(std::uint32_t* out, std::uint32_t const* digits, std::size_t len) {
+	len = limb_active_length(digits, len);
+	if constexpr(digit_is_binary<BASE>) {
+		std::copy_n(digits, len, out);
+		return len;
+	} else {
+		if(len < digit_radix_limbs<BASE>) {
+			return digit_to_limbs_basecase<BASE>(out, digits, len);
+		}
+		// powers[j] = BASE^(2^j) in binary
+		std::vector<std::vector<std::uint32_t>> powers;
+		powers.push_back({(std::uint32_t)BASE});
+		while(((std::size_t)2 << (powers.size() - 1)) < len) {
+			auto const& last = powers.back();
+			std::vector<std::uint32_t> square(2 * last.size(), 0);
+			digit_mul<(std::uint64_t)1 << 32>(square.data(), last.data(), last.size(), last.data(), last.size());
+			square.resize(limb_active_length(square.data(), square.size()));
+			powers.emplace_back(std::move(square));
+		}
+		return digit_to_limbs_rec<BASE>(out, digits, len, powers);
+	}
+}
+
+#endif // DIGIT_KERNELS_H_3A7E1C5B9D2F4A68B0C6E4D8F2A1B795
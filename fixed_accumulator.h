@@ -0,0 +1,152 @@
+/*
+ * File:      fixed_accumulator.h
+ * Author:    Daniel Hannon
+ *
+ * Copyright: 2024 Daniel Hannon
+ */
+
+#ifndef FIXED_ACCUMULATOR_H_9A1E4C7B2D5F4E8A8C3B1F6D0E2A7C95
+#define FIXED_ACCUMULATOR_H_9A1E4C7B2D5F4E8A8C3B1F6D0E2A7C95 1
+
+#include "fixed_bignum.h"
+
+#include <algorithm>
+#include <array>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * FixedAccumulator sums a large number of FixedBigNum values or products.
+ * Every limb is kept in a 64 bit lane and carries are only propagated
+ * when the result is asked for, or when the lanes are about to overflow
+ * (roughly every 2^32 limb additions). Positive and negative terms go
+ * into separate lanes so nothing has to branch on signs per addition.
+ * Like FixedBigNum itself anything that overflows U limbs is truncated.
+ */
+template<std::size_t U>
+struct FixedAccumulator {
+	constexpr FixedAccumulator() : m_positive{0}, m_negative{0}, m_pending{0}
+	{}
+
+	// this += val
+	constexpr FixedAccumulator& add(FixedBigNum<U> const& val) {
+		reserve(1);
+		auto& lanes = val.m_signed ? m_negative : m_positive;
+		for(std::size_t idx = 0; idx <= val.m_maxDigit; idx++) {
+			lanes[idx] += val.m_data[idx];
+		}
+		return *this;
+	}
+
+	// this += lhs * rhs, the product is never carried or normalized on its own
+	constexpr FixedAccumulator& addmul(FixedBigNum<U> const& lhs, FixedBigNum<U> const& rhs) {
+		// Every partial product adds its low half to one lane and its high half to the next,
+		// so no lane receives more than 2 * min(len) additions
+		reserve(2 * (std::min(lhs.m_maxDigit, rhs.m_maxDigit) + 1));
+		auto& lanes = (lhs.m_signed != rhs.m_signed) ? m_negative : m_positive;
+		for(std::size_t idx = 0; idx <= lhs.m_maxDigit; idx++) {
+			std::uint64_t digit = lhs.m_data[idx];
+			if(digit == 0) continue;
+			for(std::size_t idy = 0; (idy <= rhs.m_maxDigit) && ((idx + idy) < U); idy++) {
+				std::uint64_t product = digit * rhs.m_data[idy];
+				lanes[idx + idy] += product & 0xFFFFFFFF;
+				if((idx + idy + 1) < U) {
+					lanes[idx + idy + 1] += product >> 32;
+				}
+			}
+		}
+		return *this;
+	}
+
+	// Merges another accumulator into this one, used to combine per-thread partial sums
+	constexpr FixedAccumulator& operator+=(FixedAccumulator const& other) {
+		reserve(other.m_pending);
+		for(std::size_t idx = 0; idx < U; idx++) {
+			m_positive[idx] += other.m_positive[idx];
+			m_negative[idx] += other.m_negative[idx];
+		}
+		return *this;
+	}
+
+	// Propagates the deferred carries, after this every lane fits in 32 bits
+	constexpr void normalize() {
+		carry_lanes(m_positive);
+		carry_lanes(m_negative);
+		m_pending = 1;
+	}
+
+	constexpr FixedBigNum<U> result() const {
+		FixedAccumulator temp{*this};
+		temp.normalize();
+		FixedBigNum<U> positive{0};
+		FixedBigNum<U> negative{0};
+		for(std::size_t idx = 0; idx < U; idx++) {
+			positive.m_data[idx] = temp.m_positive[idx] & 0xFFFFFFFF;
+			negative.m_data[idx] = temp.m_negative[idx] & 0xFFFFFFFF;
+		}
+		positive.m_maxDigit = positive.get_most_populated();
+		negative.m_maxDigit = negative.get_most_populated();
+		positive -= negative;
+		return positive;
+	}
+
+private:
+	// Normalizes first if adding count more limb values to a lane could overflow it
+	constexpr void reserve(std::uint64_t count) {
+		if((m_pending + count) > sc_maxPending) {
+			normalize();
+		}
+		m_pending += count;
+	}
+
+	static constexpr void carry_lanes(std::array<std::uint64_t, U>& lanes) {
+		std::uint64_t carry = 0;
+		for(auto& lane : lanes) {
+			carry += lane;
+			lane = carry & 0xFFFFFFFF;
+			carry >>= 32;
+		}
+	}
+
+private:
+	// A lane that has taken n additions of 32 bit values holds less than n * 2^32,
+	// this leaves headroom for the carry coming in during normalization.
+	static constexpr std::uint64_t sc_maxPending = UINT32_MAX - 1;
+
+	std::array<std::uint64_t, U> m_positive;	// Lanes for the positive terms
+	std::array<std::uint64_t, U> m_negative;	// Lanes for the negative terms
+	std::uint64_t				 m_pending;		// Upper bound on the additions any lane has taken
+};
+
+/*
+ * Splits [0, count) into one contiguous block per thread, calls step(accumulator, idx)
+ * for every index and merges the per-thread accumulators in order.
+ */
+template<std::size_t U, typename F>
+FixedAccumulator<U> parallel_accumulate(std::size_t count, std::size_t threads, F&& step) {
+	threads = std::max<std::size_t>(1, std::min(threads, count));
+	std::vector<FixedAccumulator<U>> partials(threads);
+	std::vector<std::thread> workers;
+	std::size_t block = (count + threads - 1) / threads;
+	for(std::size_t thread = 0; thread < threads; thread++) {
+		workers.emplace_back([&, thread]() {
+			std::size_t end = std::min(count, (thread + 1) * block);
+			for(std::size_t idx = thread * block; idx < end; idx++) {
+				step(partials[thread], idx);
+			}
+		});
+	}
+
+	FixedAccumulator<U> result{};
+	for(std::size_t thread = 0; thread < threads; thread++) {
+		workers[thread].join();
+		result += partials[thread];
+	}
+	return result;
+}
+
+#endif // FIXED_ACCUMULATOR_H_9A1E4C7B2D5F4E8A8C3B1F6D0E2A7C95
@@ -0,0 +1,138 @@
+/*
+ * File:      fixed_base_pow.h
+ * Author:    Daniel Hannon
+ *
+ * Copyright: 2024 Daniel Hannon
+ */
+
+#ifndef FIXED_BASE_POW_H_4F9A2C6E8B1D4735A0E3C7B9D2F58E16
+#define FIXED_BASE_POW_H_4F9A2C6E8B1D4735A0E3C7B9D2F58E16 1
+
+#include "fixed_bignum.h"
+#include "limb_kernels.h"
+
+#include <algorithm>
+#include <array>
+#include <span>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+// (lhs * rhs) mod mod, both sides should already be non-negative and below mod. Modulo 0 gives 0
+template<std::size_t U>
+FixedBigNum<U> mul_mod(FixedBigNum<U> const& lhs, FixedBigNum<U> const& rhs, FixedBigNum<U> const& mod) {
+	auto lhsLimbs = lhs.limbs();
+	auto rhsLimbs = rhs.limbs();
+	auto modLimbs = mod.limbs();
+	if((modLimbs.size() == 1) && (modLimbs[0] == 0)) {
+		return FixedBigNum<U>{0};
+	}
+	std::array<std::uint32_t, (2 * U) + 1> product;
+	std::size_t len = lhsLimbs.size() + rhsLimbs.size();
+	limb_mul_basecase(product.data(), lhsLimbs.data(), lhsLimbs.size(), rhsLimbs.data(), rhsLimbs.size());
+	if(len >= modLimbs.size()) {
+		std::array<std::uint32_t, U> divisor;
+		std::array<std::uint32_t, 2 * U> quot;
+		std::copy(modLimbs.begin(), modLimbs.end(), divisor.begin());
+		limb_divmod_n(quot.data(), product.data(), len, divisor.data(), modLimbs.size());
+		len = modLimbs.size();
+	}
+	FixedBigNum<U> result{0};
+	result.import_limbs(product.data(), len);
+	return result;
+}
+
+// base^exp mod mod by plain square and multiply, exp must be non-negative
+template<std::size_t U>
+FixedBigNum<U> modpow(FixedBigNum<U> const& base, FixedBigNum<U> const& exp, FixedBigNum<U> const& mod) {
+	FixedBigNum<U> result = mul_mod(FixedBigNum<U>{1}, FixedBigNum<U>{1}, mod);
+	FixedBigNum<U> square = mul_mod(base, FixedBigNum<U>{1}, mod);
+	for(std::size_t bit = 0; bit < exp.bit_width(); bit++) {
+		if(exp.test_bit(bit)) {
+			result = mul_mod(result, square, mod);
+		}
+		square = mul_mod(square, square, mod);
+	}
+	return result;
+}
+
+/*
+ * Fixed-base exponentiation for a base and modulus that get reused with
+ * many different exponents. The constructor stores base^(d * 2^(w * j)) for
+ * every window j of the exponent and every w bit digit d, so pow() is one
+ * table lookup and one multiplication per non-zero window and never squares.
+ * The table takes (expBits / w) * (2^w - 1) numbers, w = 4 and a 256 bit
+ * exponent is 960 entries.
+ *
+ * pow() only reads the table, one FixedBasePow can be shared between threads.
+ */
+template<std::size_t U>
+struct FixedBasePow {
+	FixedBasePow(FixedBigNum<U> const& base, FixedBigNum<U> const& mod, std::size_t expBits, std::size_t window = 4)
+		: m_mod{mod}, m_one{0}, m_high{0}, m_window{std::clamp<std::size_t>(window, 1, 8)}, m_windows{0}, m_table{}
+	{
+		std::size_t digits = (std::size_t)1 << m_window;
+		m_windows = (std::max<std::size_t>(expBits, 1) + m_window - 1) / m_window;
+		m_one = mul_mod(FixedBigNum<U>{1}, FixedBigNum<U>{1}, m_mod);
+		m_table.reserve(m_windows * (digits - 1));
+
+		// step is base^(2^(w * j)) for the window being filled in
+		FixedBigNum<U> step = mul_mod(base, FixedBigNum<U>{1}, m_mod);
+		for(std::size_t idx = 0; idx < m_windows; idx++) {
+			m_table.push_back(step);
+			for(std::size_t digit = 2; digit < digits; digit++) {
+				m_table.push_back(mul_mod(m_table.back(), step, m_mod));
+			}
+			step = mul_mod(m_table.back(), step, m_mod);
+		}
+		m_high = step;
+	}
+
+	// base^exp mod mod, exp must be non-negative. Bits past expBits are
+	// handled by a square and multiply on base^(2^expBits)
+	FixedBigNum<U> pow(FixedBigNum<U> const& exp) const {
+		auto limbs = exp.limbs();
+		std::size_t digits = ((std::size_t)1 << m_window) - 1;
+		FixedBigNum<U> result = m_one;
+		bool first = true;
+		for(std::size_t idx = 0; idx < m_windows; idx++) {
+			std::size_t digit = window_digit(limbs, idx * m_window);
+			if(digit == 0) continue;
+			auto const& entry = m_table[(idx * digits) + digit - 1];
+			result = first ? entry : mul_mod(result, entry, m_mod);
+			first = false;
+		}
+		std::size_t covered = m_windows * m_window;
+		if(exp.bit_width() > covered) {
+			result = mul_mod(result, modpow(m_high, exp >> covered, m_mod), m_mod);
+		}
+		return result;
+	}
+
+	FixedBigNum<U> const& modulus() const {
+		return m_mod;
+	}
+
+private:
+	// The m_window bits of the exponent starting at bit
+	std::size_t window_digit(std::span<std::uint32_t const> limbs, std::size_t bit) const {
+		std::size_t word = bit >> 5;
+		if(word >= limbs.size()) return 0;
+		std::uint64_t buff = limbs[word];
+		if((word + 1) < limbs.size()) {
+			buff |= (std::uint64_t)limbs[word + 1] << 32;
+		}
+		return (buff >> (bit & 0x1F)) & (((std::uint64_t)1 << m_window) - 1);
+	}
+
+private:
+	FixedBigNum<U>				m_mod;	   // The modulus
+	FixedBigNum<U>				m_one;	   // 1 mod m_mod, so a modulus of 1 gives 0
+	FixedBigNum<U>				m_high;	   // base^(2^(m_windows * m_window)) for oversized exponents
+	std::size_t					m_window;  // Bits per window
+	std::size_t					m_windows; // Number of windows in the table
+	std::vector<FixedBigNum<U>> m_table;   // base^(d * 2^(w * j)) at j * (2^w - 1) + d - 1
+};
+
+#endif // FIXED_BASE_POW_H_4F9A2C6E8B1D4735A0E3C7B9D2F58E16
@@ -9,13 +9,17 @@
 
 #include "humanreadable.h"
 #include "arbitrary_bignum.h"
+#include "limb_io.h"
+#include "limb_kernels.h"
 #include <ostream>
 
 #include <bit>
 #include <compare>
 
+#include <algorithm>
 #include <array>
 #include <concepts>
+#include <span>
 
 #include <cmath>
 #include <cstddef>
@@ -23,6 +27,18 @@
 
 #include <iostream>
 
+template<std::size_t U>
+struct FixedUInt;
+
+template<std::size_t U>
+struct FixedAccumulator;
+
+template<std::size_t U>
+struct HeapFixedBigNum;
+
+template<std::size_t U>
+struct SpecialModulus;
+
 /*
  * Fixed-size big number type, it does everything you'd expect.
  * this type does not utilize disk storage and is used to do
@@ -36,33 +52,20 @@ struct FixedBigNum {
 	constexpr FixedBigNum() : m_data{0}, m_signed{false}, m_maxDigit{0}
 	{}
 	
-	constexpr FixedBigNum(std::signed_integral auto x) : m_data{0}, m_signed{std::signbit(x)}, m_maxDigit{0}
+	constexpr FixedBigNum(std::signed_integral auto x) : FixedBigNum{split_scalar(x).second}
 	{
-		if(m_signed) {
-			x *= -1;
-		}
-		if(x > UINT32_MAX) {
-			m_maxDigit = 1;
-		}
-		std::size_t idx = 0;
-		while(x > 0) {
-			m_data[idx] = x % ((std::uint64_t)UINT32_MAX + 1);
-			x /= ((std::uint64_t)UINT32_MAX + 1);
-			idx++;
-		}
+		m_signed = (x < 0);
 	}
 
 	constexpr FixedBigNum(std::unsigned_integral auto x) : m_data{0}, m_signed{false}, m_maxDigit{0}
 	{
 		std::size_t idx = 0;
-		if(x > UINT32_MAX) {
-			m_maxDigit = 1;
-		}
-		while(x > 0) {
+		while((x > 0) && (idx < U)) {
 			m_data[idx] = x % ((std::uint64_t)UINT32_MAX + 1);
 			x /= ((std::uint64_t)UINT32_MAX + 1);
 			idx++;
 		}
+		m_maxDigit = (idx != 0) ? idx - 1 : 0;
 	}
 
 	template<size_t T>
@@ -70,12 +73,34 @@ struct FixedBigNum {
 	{
 		if constexpr(T > U) {
 			// Truncate the number
-			m_data = {x.m_data.begin(), x.m_data.begin() + U};
+			std::copy_n(x.m_data.begin(), U, m_data.begin());
+			m_maxDigit = get_most_populated();
 		} else {
 			// Copy the number entirely
-			m_data = {x.m_data.begin(), x.m_data.end()};
+			std::copy_n(x.m_data.begin(), T, m_data.begin());
+		}
+	}
+
+	// Binary based ArbitraryBigNums are copied limb for limb, other bases
+	// go through a chunked Horner evaluation. Anything past U limbs is truncated.
+	template<std::size_t MAX_VAL, typename Storage>
+	FixedBigNum(ArbitraryBigNum<MAX_VAL, Storage> const& x) : m_data{0}, m_signed{x.m_signed}, m_maxDigit{0}
+	{
+		x.export_binary_limbs(m_data.data(), U);
+		m_maxDigit = get_most_populated();
+		if((m_maxDigit == 0) && (m_data[0] == 0)) {
+			m_signed = false;
 		}
 	}
+
+	template<std::size_t MAX_VAL, typename Storage>
+	FixedBigNum& operator=(ArbitraryBigNum<MAX_VAL, Storage> const& x) {
+		FixedBigNum temp{x};
+		m_data.swap(temp.m_data);
+		m_signed = temp.m_signed;
+		m_maxDigit = temp.m_maxDigit;
+		return *this;
+	}
 // Friend operators
 	friend FixedBigNum abs(FixedBigNum const&);
 
@@ -104,6 +129,20 @@ struct FixedBigNum {
 		return std::is_eq(*this <=> cmp);
 	}
 
+	constexpr std::partial_ordering operator<=>(scalar_int auto val) const {
+		auto [neg, mag] = split_scalar(val);
+		if(is_zero() && (mag == 0)) return std::partial_ordering::equivalent;
+		if(auto signs = neg <=> m_signed; signs != 0) {
+			return signs;
+		}
+		auto res = compare_magnitude(mag);
+		return m_signed ? (0 <=> res) : (res <=> 0);
+	}
+
+	constexpr bool operator==(scalar_int auto val) const {
+		return std::is_eq(*this <=> val);
+	}
+
 // Arithmetic
 	constexpr FixedBigNum& operator+=(FixedBigNum const& add) {
 		if(m_signed != add.m_signed) {
@@ -112,22 +151,27 @@ struct FixedBigNum {
 			m_signed ^= true;
 			return *this;
 		}
-		
+
+		if constexpr(sc_unrolled) {
+			limb_add_fixed<U>(m_data.data(), m_data.data(), add.m_data.data());
+			m_maxDigit = limb_top_fixed<U>(m_data.data());
+			return *this;
+		}
+
 		std::uint64_t carry = 0U;
-		m_maxDigit = std::max(m_maxDigit, add.m_maxDigit) + 1;
-		for(std::size_t idx = 0; idx < m_maxDigit; idx++) {
+		std::size_t limit = std::min(std::max(m_maxDigit, add.m_maxDigit) + 1, U);
+		for(std::size_t idx = 0; idx < limit; idx++) {
 			carry += ((std::uint64_t)(m_data[idx] & 0xFFFFFFFF)) + (std::uint64_t)(add.m_data[idx] & 0xFFFFFFFF);
 			m_data[idx] = carry & 0xFFFFFFFF;
 			carry >>= 32;
 		}
 
-		if((m_maxDigit < U) && (carry != 0)) {
-			m_data[m_maxDigit] = carry & 0xFFFFFFFF;
+		if((limit < U) && (carry != 0)) {
+			m_data[limit] = carry & 0xFFFFFFFF;
 		}
 
-		while(!m_data[m_maxDigit]) {
-			m_maxDigit--;
-		}
+		m_maxDigit = std::min(limit, U - 1);
+		shrink_max_digit();
 		return *this;		
 	}
 
@@ -161,9 +205,18 @@ struct FixedBigNum {
 			return *this;
 		}
 
-		if(abs(*this) < abs(sub)) {
+		if constexpr(sc_unrolled) {
+			// The sign flips if sub had the larger magnitude
+			bool less = limb_sub_abs_fixed<U>(m_data.data(), m_data.data(), sub.m_data.data()) != 0;
+			m_maxDigit = limb_top_fixed<U>(m_data.data());
+			m_signed = (m_signed != less) && !is_zero();
+			return *this;
+		}
+
+		if(compare_magnitude(sub) == std::strong_ordering::less) {
 			FixedBigNum temp = sub - *this;
 			m_data.swap(temp.m_data);
+			m_maxDigit = temp.m_maxDigit;
 			m_signed ^= true;
 			return *this;
 		}
@@ -171,8 +224,8 @@ struct FixedBigNum {
 		std::uint64_t buff = 0;
 		std::uint64_t tmp = 0;
 		bool all_zeroes = true;
-		m_maxDigit = std::max(m_maxDigit, sub.m_maxDigit) + 1;
-		for(auto idx = 0; idx < m_maxDigit; idx++) {
+		std::size_t limit = std::max(m_maxDigit, sub.m_maxDigit) + 1;
+		for(std::size_t idx = 0; idx < limit; idx++) {
 			tmp = m_data[idx] & 0xFFFFFFFF;
 			buff = tmp - (sub.m_data[idx]&0xFFFFFFFF) - buff;
 			m_data[idx] = buff & 0xFFFFFFFF;
@@ -184,9 +237,8 @@ struct FixedBigNum {
 			m_signed = false;
 		}
 
-		while(!m_data[m_maxDigit]) {
-			m_maxDigit--;
-		}
+		m_maxDigit = limit - 1;
+		shrink_max_digit();
 
 		return *this;
 	}
@@ -208,58 +260,35 @@ struct FixedBigNum {
 	}
 
 	constexpr FixedBigNum operator*(FixedBigNum const& mult) const {
-		if(m_maxDigit == 0 && m_data[0] == 0) return {0};
-		if(U <= 80000) {
-			FixedBigNum temp{0};
-			temp.m_maxDigit = std::min(U - 1, (m_maxDigit + 1) * (mult.m_maxDigit + 1)) + 1;
-			for(std::size_t idx = 0; idx < temp.m_maxDigit; idx++) {
-				std::uint64_t carry = 0;
-				for(std::size_t idy = 0; (idx + idy) < U; idy++) {
-					carry += ((std::uint64_t)(m_data[idx] & 0xFFFFFFFF)) * ((std::uint64_t)(mult.m_data[idy] & 0xFFFFFFFF));
-					carry += (temp.m_data[idx+idy]) & 0xFFFFFFFF;
-					temp.m_data[idx+idy] = carry & 0xFFFFFFFF;
-					carry >>= 32;
-				}
-			}
-
-			if(m_signed != mult.m_signed) {
-				temp.m_signed = true;
+		FixedBigNum temp{0};
+		if(is_zero() || mult.is_zero()) return temp;
+		std::size_t lhsLen = m_maxDigit + 1;
+		std::size_t rhsLen = mult.m_maxDigit + 1;
+		if constexpr(sc_unrolled) {
+			// Below 8 limbs the unrolled product always wins, above it only
+			// when the product gets truncated and the word kernels can't be used
+			if((U <= 8) || ((lhsLen + rhsLen) > U)) {
+				limb_mul_lo_fixed<U>(temp.m_data.data(), m_data.data(), mult.m_data.data());
+				temp.m_maxDigit = limb_top_fixed<U>(temp.m_data.data());
+				temp.m_signed = (m_signed != mult.m_signed) && !temp.is_zero();
+				return temp;
 			}
-
-			while(!temp.m_data[temp.m_maxDigit]) {
-				temp.m_maxDigit--;
-			}
-
-			return temp;
+		}
+		if((lhsLen + rhsLen) <= U) {
+			limb_mul_basecase(temp.m_data.data(), m_data.data(), lhsLen, mult.m_data.data(), rhsLen);
 		} else {
-			std::array<std::uint64_t, U> convulution{0};
-			FixedBigNum result{0};
-			result.m_maxDigit = std::min(U - 1, (m_maxDigit + 1) * (mult.m_maxDigit + 1)) + 1;
-
-			for(std::size_t idx = 0; idx <= m_maxDigit; idx++) {
-				if(m_data[idx] == 0) continue;
-				for(std::size_t idy = 0; (idx + idy) < U; idy++) {
-					convulution[idx + idy] += ((std::uint64_t)m_data[idx] & 0xFFFFFFFF) * ((std::uint64_t)mult.m_data[idy] & 0xFFFFFFFF);
-				}
-			}
-
-			std::uint64_t carry = 0;
-			for(std::size_t idx = 0; idx < U; idx++) {
-				carry += convulution[idx];
-				result.m_data[idx] = (carry & 0xFFFFFFFF);
-				carry = carry >> 32;
-			}
-			
-			while((result.m_data[result.m_maxDigit] == 0) && (result.m_maxDigit != 0)) {
-				result.m_maxDigit--;
-			}
-
-			if(m_signed != mult.m_signed) {
-				result.m_signed = true;
+			// The product can overflow so only the low U limbs are worked out
+			for(std::size_t idx = 0; idx < rhsLen; idx++) {
+				std::size_t len = std::min(lhsLen, U - idx);
+				auto carry = limb_addmul_1(temp.m_data.data() + idx, m_data.data(), len, mult.m_data[idx]);
+				limb_add_1(temp.m_data.data() + idx + len, U - (idx + len), carry);
 			}
-
-			return result;
 		}
+
+		temp.m_maxDigit = std::min(lhsLen + rhsLen, U) - 1;
+		temp.shrink_max_digit();
+		temp.m_signed = (m_signed != mult.m_signed) && !temp.is_zero();
+		return temp;
 	}
 
 	constexpr FixedBigNum& operator*=(FixedBigNum const& mult) {
@@ -276,6 +305,7 @@ struct FixedBigNum {
 		auto tmp = simple_divide(div);
 		m_data.swap(tmp.first.m_data);
 		m_signed = tmp.first.m_signed;
+		m_maxDigit = tmp.first.m_maxDigit;
 		return *this;
 	}
 
@@ -288,6 +318,7 @@ struct FixedBigNum {
 		auto tmp = simple_divide(div);
 		m_data.swap(tmp.second.m_data);
 		m_signed = tmp.second.m_signed;
+		m_maxDigit = tmp.second.m_maxDigit;
 		return *this;
 	}
 
@@ -296,6 +327,208 @@ struct FixedBigNum {
 		return tmp.second;
 	}
 
+// Scalar arithmetic, these never build a FixedBigNum out of the scalar
+// and only touch the active limbs
+	constexpr FixedBigNum& operator+=(scalar_int auto val) {
+		auto [neg, mag] = split_scalar(val);
+		add_scalar(neg, mag);
+		return *this;
+	}
+
+	constexpr FixedBigNum operator+(scalar_int auto val) const {
+		FixedBigNum temp{*this};
+		temp += val;
+		return temp;
+	}
+
+	constexpr FixedBigNum& operator-=(scalar_int auto val) {
+		auto [neg, mag] = split_scalar(val);
+		add_scalar(!neg, mag);
+		return *this;
+	}
+
+	constexpr FixedBigNum operator-(scalar_int auto val) const {
+		FixedBigNum temp{*this};
+		temp -= val;
+		return temp;
+	}
+
+	constexpr FixedBigNum& operator*=(scalar_int auto val) {
+		auto [neg, mag] = split_scalar(val);
+		std::size_t len = m_maxDigit + 1;
+		if((mag >> 32) == 0) {
+			auto carry = limb_mul_1_add(m_data.data(), len, mag & 0xFFFFFFFF, 0);
+			if(len < U) {
+				m_data[len] = carry;
+			}
+		} else {
+			// Top down so every limb is read before anything carries into it
+			for(std::size_t idx = len; idx > 0; idx--) {
+				std::uint64_t digit = m_data[idx - 1];
+				m_data[idx - 1] = 0;
+				add_at(idx - 1, digit * (mag & 0xFFFFFFFF));
+				add_at(idx, digit * (mag >> 32));
+			}
+		}
+		m_maxDigit = std::min(len + 1, U - 1);
+		shrink_max_digit();
+		m_signed = (m_signed != neg) && !is_zero();
+		return *this;
+	}
+
+	constexpr FixedBigNum operator*(scalar_int auto val) const {
+		FixedBigNum temp{*this};
+		temp *= val;
+		return temp;
+	}
+
+	// Divides in place (truncating towards 0, like the builtin types) in a single
+	// pass over the active limbs. Returns the magnitude of the remainder, the
+	// remainder itself carries the sign of the dividend. Dividing by 0 gives 0.
+	constexpr std::uint64_t divmod(scalar_int auto div) {
+		auto [neg, mag] = split_scalar(div);
+		bool dividendSign = m_signed;
+		std::uint64_t rem = 0;
+		if(mag == 0) {
+			m_data.fill(0);
+			m_maxDigit = 0;
+		} else if((mag >> 32) == 0) {
+			rem = limb_divmod_1(m_data.data(), m_maxDigit + 1, mag & 0xFFFFFFFF);
+		} else {
+#ifdef __SIZEOF_INT128__
+			unsigned __int128 buff = 0;
+			for(std::size_t idx = m_maxDigit + 1; idx > 0; idx--) {
+				buff = (buff << 32) | m_data[idx - 1];
+				m_data[idx - 1] = (buff / mag) & 0xFFFFFFFF;
+				buff %= mag;
+			}
+			rem = (std::uint64_t)buff;
+#else
+			auto tmp = simple_divide(FixedBigNum{mag});
+			m_data.swap(tmp.first.m_data);
+			rem = tmp.second.low_word();
+#endif
+		}
+		shrink_max_digit();
+		m_signed = (dividendSign != neg) && !is_zero();
+		return rem;
+	}
+
+	constexpr FixedBigNum& operator/=(scalar_int auto val) {
+		divmod(val);
+		return *this;
+	}
+
+	constexpr FixedBigNum operator/(scalar_int auto val) const {
+		FixedBigNum temp{*this};
+		temp.divmod(val);
+		return temp;
+	}
+
+	constexpr FixedBigNum& operator%=(scalar_int auto val) {
+		bool sign = m_signed;
+		std::uint64_t rem = divmod(val);
+		*this = FixedBigNum{rem};
+		m_signed = sign && (rem != 0);
+		return *this;
+	}
+
+	constexpr FixedBigNum operator%(scalar_int auto val) const {
+		FixedBigNum temp{*this};
+		temp %= val;
+		return temp;
+	}
+
+	// this /= div for when div is known to divide this exactly (binomials, gcd
+	// normalization, product trees). Runs low to high with div's 2-adic inverse
+	// so it skips the trial quotients of long division. If div does not divide
+	// this the result is garbage, dividing by 0 gives 0.
+	constexpr FixedBigNum& divexact(FixedBigNum const& div) {
+		FixedBigNum divisor{div};
+		FixedBigNum quotient{0};
+		auto len = limb_divexact(quotient.m_data.data(), m_data.data(), m_maxDigit + 1, divisor.m_data.data(), div.m_maxDigit + 1);
+		quotient.m_maxDigit = std::max<std::size_t>(limb_active_length(quotient.m_data.data(), len), 1) - 1;
+		quotient.m_signed = (m_signed != div.m_signed) && !quotient.is_zero();
+		*this = quotient;
+		return *this;
+	}
+
+// Bit queries, these work on the magnitude and ignore the sign
+	// Number of bits needed to hold the magnitude, 0 for 0
+	constexpr std::size_t bit_width() const {
+		return (m_maxDigit * 32) + std::bit_width(m_data[m_maxDigit]);
+	}
+
+	// Number of set bits in the magnitude
+	constexpr std::size_t popcount() const {
+		std::size_t count = 0;
+		for(std::size_t idx = 0; idx <= m_maxDigit; idx++) {
+			count += std::popcount(m_data[idx]);
+		}
+		return count;
+	}
+
+	// Number of zero bits below the lowest set bit
+	// Like std::countr_zero this is the full width for 0, U * 32 bits
+	constexpr std::size_t countr_zero() const {
+		for(std::size_t idx = 0; idx <= m_maxDigit; idx++) {
+			if(m_data[idx] != 0) {
+				return (idx * 32) + std::countr_zero(m_data[idx]);
+			}
+		}
+		return U * 32;
+	}
+
+	constexpr bool test_bit(std::size_t bit) const {
+		if((bit >> 5) > m_maxDigit) return false;
+		return (m_data[bit >> 5] >> (bit & 0x1F)) & 1;
+	}
+
+	// Sets (or clears) a single bit, bits past the width of the number are ignored
+	constexpr FixedBigNum& set_bit(std::size_t bit, bool value = true) {
+		std::size_t word = bit >> 5;
+		if(word >= U) return *this;
+		std::uint32_t mask = 1U << (bit & 0x1F);
+		if(value) {
+			m_data[word] |= mask;
+			m_maxDigit = std::max(m_maxDigit, word);
+		} else {
+			m_data[word] &= ~mask;
+			shrink_max_digit();
+			if((m_maxDigit == 0) && (m_data[0] == 0)) {
+				m_signed = false;
+			}
+		}
+		return *this;
+	}
+
+// Raw limb access, these only deal with the magnitude, the sign is left to the caller
+	// View of the active limbs, least significant first. Never empty, 0 is a single 0 limb
+	constexpr std::span<std::uint32_t const> limbs() const {
+		return {m_data.data(), m_maxDigit + 1};
+	}
+
+	// Number of W words export_limbs needs for the magnitude, 0 for 0
+	template<limb_word W>
+	constexpr std::size_t export_size() const {
+		return limb_word_count<W>(m_data.data(), m_maxDigit + 1);
+	}
+
+	// Writes the magnitude into count words, zero padded or truncated to fit
+	template<limb_word W>
+	constexpr void export_limbs(W* out, std::size_t count, WordOrder order = WordOrder::least_significant_first, std::endian endian = std::endian::native) const {
+		limb_export_words(out, count, m_data.data(), m_maxDigit + 1, order, endian);
+	}
+
+	// Replaces this with the non-negative value held in count words, anything past U limbs is dropped
+	template<limb_word W>
+	constexpr FixedBigNum& import_limbs(W const* words, std::size_t count, WordOrder order = WordOrder::least_significant_first, std::endian endian = std::endian::native) {
+		limb_import_words(m_data.data(), U, words, count, order, endian);
+		m_signed = false;
+		m_maxDigit = get_most_populated();
+		return *this;
+	}
+
 // Bitshift operators
 	constexpr FixedBigNum& operator<<=(std::size_t const& val) {
 		auto word_offset = val >> 5;
@@ -320,17 +553,20 @@ struct FixedBigNum {
 				m_data[0] = m_data[0] << bit_offset;
 			}
 		} else {
-			for(int idx = U - 2; idx > word_offset; idx--) {
-				buff = (m_data[idx - word_offset] & 0xFFFFFFFF) << bit_offset;
-				buff ^= (m_data[(idx - 1) - word_offset] & 0xFFFFFFFF) >> (32 - bit_offset);
-				m_data[idx] = buff & 0xFFFFFFFF;
+			for(std::size_t idx = U; idx > word_offset; idx--) {
+				buff = (m_data[(idx - 1) - word_offset] & 0xFFFFFFFF) << bit_offset;
+				if((idx - 1) > word_offset) {
+					buff ^= ((std::uint64_t)(m_data[(idx - 2) - word_offset] & 0xFFFFFFFF) << bit_offset) >> 32;
+				}
+				m_data[idx - 1] = buff & 0xFFFFFFFF;
 			}
 
-			for(std::size_t idx = 0; idx < word_offset; idx++) {
+			for(std::size_t idx = 0; idx < std::min<std::size_t>(word_offset, U); idx++) {
 				m_data[idx] = 0;
 			}
 		}
 
+		m_maxDigit = get_most_populated();
 		return *this;
 	}
 
@@ -348,6 +584,7 @@ struct FixedBigNum {
 			for(auto& v: m_data) {
 				v = 0;
 			}
+			m_maxDigit = 0;
 			return *this;
 		}
 
@@ -359,11 +596,12 @@ struct FixedBigNum {
 			m_data[0] = temp & 0xFFFFFFFF;
 			m_data[1] = (temp >> 32) & 0xFFFFFFFF;
 		} else {
-			std::uint64_t buff = m_data[word_offset+1];
-			for(auto idx = 0; (idx + word_offset) < U; idx++) {
-				buff <<= (32-bit_offset);
-				buff ^= m_data[idx + word_offset] >> bit_offset;
-				m_data[idx] = buff & 0xFFFFFFFF;
+			for(std::size_t idx = 0; (idx + word_offset) < U; idx++) {
+				std::uint64_t buff = m_data[idx + word_offset] & 0xFFFFFFFF;
+				if((idx + word_offset + 1) < U) {
+					buff ^= (std::uint64_t)(m_data[idx + word_offset + 1] & 0xFFFFFFFF) << 32;
+				}
+				m_data[idx] = (buff >> bit_offset) & 0xFFFFFFFF;
 			}
 
 			for(auto idx = U - word_offset; idx < U; idx++) {
@@ -371,6 +609,7 @@ struct FixedBigNum {
 			}
 		}
 
+		m_maxDigit = get_most_populated();
 		return *this;
 	}
 
@@ -385,6 +624,8 @@ struct FixedBigNum {
 		for(auto idx = 0; idx < U; idx++) {
 			m_data[idx] &= other.m_data[idx];
 		}
+		m_maxDigit = get_most_populated();
+		return *this;
 	}
 
 	constexpr FixedBigNum operator&(FixedBigNum const& other) const {
@@ -397,6 +638,7 @@ struct FixedBigNum {
 		for(auto idx = 0; idx < U; idx++) {
 			m_data[idx] ^= other.m_data[idx];
 		}
+		m_maxDigit = get_most_populated();
 		return *this;
 	}
 
@@ -410,6 +652,7 @@ struct FixedBigNum {
 		for(auto idx = 0; idx < U; idx++) {
 			m_data[idx] |= other.m_data[idx];
 		}
+		m_maxDigit = get_most_populated();
 		return *this;
 	}
 
@@ -424,12 +667,11 @@ struct FixedBigNum {
 		for(auto & v : temp.m_data) {
 			v = ~v;
 		}
+		temp.m_maxDigit = temp.get_most_populated();
 		return temp;
 	}
 
 	friend std::ostream & operator<<(std::ostream & os, FixedBigNum const& bigNum) {
-		//const HumanReadableNum HrU32MaxAdd1{0x100000000};
-		std::uint64_t HrU32MaxAdd1 = 0x100000000;
 		if constexpr(U == 1) {
 			if(bigNum.m_signed) {
 				os << '-';
@@ -442,15 +684,7 @@ struct FixedBigNum {
 			std::uint64_t val = (bigNum.m_data[0] & 0xFFFFFFFF) ^ ((std::uint64_t)(bigNum.m_data[1] & 0xFFFFFFFF) << 32);
 			os << val;
 		} else {
-			ArbitraryBigNum<ARBITRARY_PRINTABLE> tmp{0};
-			//HumanReadableNum tmp{0};
-			for(auto idx = bigNum.m_maxDigit + 1; idx > 0; idx--) {
-				tmp *= HrU32MaxAdd1;
-				tmp += bigNum.m_data[idx - 1];
-			}
-			if(bigNum.m_signed) {
-				os << '-';
-			}
+			ArbitraryBigNum<ARBITRARY_PRINTABLE> tmp{bigNum};
 			os << tmp;
 		}
 		return os;
@@ -466,7 +700,49 @@ struct FixedBigNum {
 		return num.m_signed;
 	}
 
+	// Top k limbs of |lhs| * |rhs| with the sign of the product, which is the
+	// product shifted right by 32 * (active limbs of lhs + active limbs of rhs - k).
+	// The low partial products are never formed so the magnitude can come out
+	// one below the exact value, but never above it. k is capped at U.
+	friend constexpr FixedBigNum mul_high(FixedBigNum const& lhs, FixedBigNum const& rhs, std::size_t k) {
+		k = std::min(k, U);
+		std::size_t lhsLen = lhs.m_maxDigit + 1;
+		std::size_t rhsLen = rhs.m_maxDigit + 1;
+		FixedBigNum result{0};
+		if(std::min(lhsLen, rhsLen) < limb_mul_high_limbs) {
+			std::array<std::uint32_t, 2 * U> full{};
+			limb_mul_basecase(full.data(), lhs.m_data.data(), lhsLen, rhs.m_data.data(), rhsLen);
+			std::size_t skip = (lhsLen + rhsLen) - std::min(k, lhsLen + rhsLen);
+			std::copy_n(full.begin() + skip, k, result.m_data.begin());
+		} else {
+			std::array<std::uint32_t, U + 10> high{};
+			auto at = limb_mul_high(high.data(), lhs.m_data.data(), lhsLen, rhs.m_data.data(), rhsLen, k);
+			std::copy_n(high.begin() + at, k, result.m_data.begin());
+		}
+		result.m_maxDigit = result.get_most_populated();
+		result.m_signed = (lhs.m_signed != rhs.m_signed) && !result.is_zero();
+		return result;
+	}
+
 private:
+	template<std::size_t>
+	friend struct FixedBigNum;
+
+	template<std::size_t, typename>
+	friend struct ArbitraryBigNum;
+
+	template<std::size_t>
+	friend struct FixedUInt;
+
+	template<std::size_t>
+	friend struct FixedAccumulator;
+
+	template<std::size_t>
+	friend struct HeapFixedBigNum;
+
+	template<std::size_t>
+	friend struct SpecialModulus;
+
 	constexpr std::size_t get_most_populated() const {
 		for(std::size_t idx = U - 1; idx > 0; idx--) {
 			if(m_data[idx]) return idx;
@@ -474,6 +750,95 @@ private:
 		return 0;
 	}
 
+	constexpr bool is_zero() const {
+		return (m_maxDigit == 0) && (m_data[0] == 0);
+	}
+
+	// The low 64 bits of the magnitude
+	constexpr std::uint64_t low_word() const {
+		std::uint64_t word = m_data[0];
+		if constexpr(U > 1) {
+			word |= (std::uint64_t)m_data[1] << 32;
+		}
+		return word;
+	}
+
+	// Splits a builtin integer into its sign and magnitude, this is safe for INT64_MIN
+	static constexpr std::pair<bool, std::uint64_t> split_scalar(scalar_int auto val) {
+		if constexpr(std::is_signed_v<decltype(val)>) {
+			if(val < 0) {
+				return {true, (std::uint64_t)0 - (std::uint64_t)(std::int64_t)val};
+			}
+		}
+		return {false, (std::uint64_t)val};
+	}
+
+	// Compares magnitudes without copying either number
+	constexpr std::strong_ordering compare_magnitude(FixedBigNum const& other) const {
+		if(auto width = m_maxDigit <=> other.m_maxDigit; width != 0) {
+			return width;
+		}
+		for(std::size_t idx = m_maxDigit + 1; idx > 0; idx--) {
+			if(auto res = m_data[idx - 1] <=> other.m_data[idx - 1]; res != 0) return res;
+		}
+		return std::strong_ordering::equal;
+	}
+
+	constexpr std::strong_ordering compare_magnitude(std::uint64_t mag) const {
+		if(m_maxDigit > 1) return std::strong_ordering::greater;
+		return low_word() <=> mag;
+	}
+
+	// Adds val to the magnitude starting at limb pos, whatever carries out of limb U - 1 is dropped
+	constexpr void add_at(std::size_t pos, std::uint64_t val) {
+		for(std::size_t idx = pos; (idx < U) && (val != 0); idx++) {
+			val += m_data[idx];
+			m_data[idx] = val & 0xFFFFFFFF;
+			val >>= 32;
+			m_maxDigit = std::max(m_maxDigit, idx);
+		}
+	}
+
+	// this += (neg ? -mag : mag)
+	constexpr void add_scalar(bool neg, std::uint64_t mag) {
+		if(is_zero()) {
+			m_signed = neg;
+		}
+		if(neg == m_signed) {
+			add_at(0, mag);
+		} else if(compare_magnitude(mag) != std::strong_ordering::less) {
+			std::uint64_t borrow = mag;
+			for(std::size_t idx = 0; (idx <= m_maxDigit) && (borrow != 0); idx++) {
+				std::uint64_t diff = (std::uint64_t)m_data[idx] - (borrow & 0xFFFFFFFF);
+				m_data[idx] = diff & 0xFFFFFFFF;
+				borrow = (borrow >> 32) + (diff >> 63);
+			}
+			shrink_max_digit();
+		} else {
+			// The magnitude fits in 64 bits so the result does too
+			std::uint64_t result = mag - low_word();
+			m_data[0] = result & 0xFFFFFFFF;
+			if constexpr(U > 1) {
+				m_data[1] = (result >> 32) & 0xFFFFFFFF;
+			}
+			m_maxDigit = 0;
+			if constexpr(U > 1) {
+				m_maxDigit = (m_data[1] != 0) ? 1 : 0;
+			}
+			m_signed = neg;
+		}
+		if(is_zero()) {
+			m_signed = false;
+		}
+	}
+
+	// Walks m_maxDigit back down past any limbs that have been zeroed
+	constexpr void shrink_max_digit() {
+		while((m_maxDigit != 0) && (m_data[m_maxDigit] == 0)) {
+			m_maxDigit--;
+		}
+	}
+
 	// TODO:Test This!!!!!!!!!
 	constexpr std::pair<FixedBigNum,FixedBigNum> simple_divide(FixedBigNum const& div) const {
 		if((*this == 0) || (div == 0)) {
@@ -481,35 +846,37 @@ private:
 		}
 		std::pair<FixedBigNum,FixedBigNum> result {0,*this};
 
-		std::size_t len_divisor = div.get_most_populated();
-		std::size_t len_dividend = get_most_populated();
-
-		if(len_divisor > len_dividend) {
+		if(div.m_maxDigit > m_maxDigit) {
 			return result;
 		}
 
-		int dividend_pop_bits = (32 - std::countl_zero(m_data[len_dividend])) + (len_dividend * 32);
-		int divisor_pop_bits = (32 - std::countl_zero(div.m_data[len_divisor])) + (len_divisor * 32);
-
-		int operations = (dividend_pop_bits - divisor_pop_bits);
+		int operations = (int)bit_width() - (int)div.bit_width();
 
 		if(operations < 0) return result;
 
+		// Work on magnitudes, the signs are put back at the end
+		result.second.m_signed = false;
 		FixedBigNum divisor = div << operations;
-		while((abs(divisor) >= abs(div)) && (operations >= 0)) {
+		divisor.m_signed = false;
+		while(operations >= 0) {
 			result.first <<= 1;
-			if(result.second >= divisor) {
+			if(result.second.compare_magnitude(divisor) != std::strong_ordering::less) {
 				result.second -= divisor;
-				result.first++;
+				result.first.m_data[0] |= 1;
 			}
 			divisor >>= 1;
 			operations--;
-		} 
+		}
 
+		result.first.m_signed = (m_signed != div.m_signed) && !result.first.is_zero();
+		result.second.m_signed = m_signed && !result.second.is_zero();
 		return result;
 	}
 
 private:
+	// Widths up to int1024 use the unrolled fixed length kernels
+	static constexpr bool sc_unrolled = (U <= 32);
+
 	std::array<std::uint32_t, U> m_data;     // The number data itself
 	bool						 m_signed;	 // The sign for the number
 	std::size_t					 m_maxDigit; // The Maximum Occupied digit
@@ -0,0 +1,259 @@
+/*
+ * File:      fixed_uint.h
+ * Author:    Daniel Hannon
+ *
+ * Copyright: 2024 Daniel Hannon
+ */
+
+#ifndef FIXED_UINT_H_3B8F0E6D5C2A4F1E9D7B6A5C4E3F2D1B
+#define FIXED_UINT_H_3B8F0E6D5C2A4F1E9D7B6A5C4E3F2D1B 1
+
+#include "fixed_bignum.h"
+#include "limb_kernels.h"
+
+#include <algorithm>
+#include <array>
+#include <compare>
+#include <concepts>
+#include <ostream>
+
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * Fixed-size unsigned number type that wraps modulo 2^(32U).
+ * Negative values are stored in two's complement, so addition,
+ * subtraction and negation are straight carry chains with no
+ * sign handling. Use FixedBigNum if you need signed magnitudes.
+ */
+template<std::size_t U>
+struct FixedUInt {
+	static_assert(U != 0, "You cant have a 0 limb number");
+
+	constexpr FixedUInt() : m_data{0}
+	{}
+
+	// Negative values wrap around, so FixedUInt{-1} has every bit set
+	constexpr FixedUInt(std::signed_integral auto x) : m_data{0}
+	{
+		std::uint64_t bits = static_cast<std::uint64_t>(static_cast<std::int64_t>(x));
+		std::uint32_t fill = (x < 0) ? 0xFFFFFFFF : 0;
+		m_data.fill(fill);
+		m_data[0] = bits & 0xFFFFFFFF;
+		if constexpr(U > 1) {
+			m_data[1] = (bits >> 32) & 0xFFFFFFFF;
+		}
+	}
+
+	constexpr FixedUInt(std::unsigned_integral auto x) : m_data{0}
+	{
+		std::uint64_t bits = x;
+		m_data[0] = bits & 0xFFFFFFFF;
+		if constexpr(U > 1) {
+			m_data[1] = (bits >> 32) & 0xFFFFFFFF;
+		}
+	}
+
+	// Takes the value modulo 2^(32U), negative numbers end up in two's complement
+	template<std::size_t T>
+	constexpr FixedUInt(FixedBigNum<T> const& x) : m_data{0}
+	{
+		std::copy_n(x.m_data.begin(), std::min(T, U), m_data.begin());
+		if(x.m_signed) {
+			limb_neg_n(m_data.data(), m_data.data(), U);
+		}
+	}
+
+	// The result is always the non-negative value in [0, 2^(32U))
+	template<std::size_t T>
+	constexpr explicit operator FixedBigNum<T>() const {
+		FixedBigNum<T> result{0};
+		std::copy_n(m_data.begin(), std::min(T, U), result.m_data.begin());
+		result.m_maxDigit = result.get_most_populated();
+		return result;
+	}
+
+// Comparators
+	constexpr std::strong_ordering operator<=>(FixedUInt const& vs) const {
+		for(auto idx = U; idx > 0; idx--) {
+			if(auto res = m_data[idx - 1] <=> vs.m_data[idx - 1]; res != 0) return res;
+		}
+		return std::strong_ordering::equal;
+	}
+
+	constexpr bool operator==(FixedUInt const& cmp) const {
+		return m_data == cmp.m_data;
+	}
+
+// Arithmetic
+	constexpr FixedUInt& operator+=(FixedUInt const& add) {
+		limb_add_n(m_data.data(), m_data.data(), add.m_data.data(), U);
+		return *this;
+	}
+
+	constexpr FixedUInt operator+(FixedUInt const& add) const {
+		FixedUInt temp{*this};
+		temp += add;
+		return temp;
+	}
+
+	constexpr FixedUInt& operator-=(FixedUInt const& sub) {
+		limb_sub_n(m_data.data(), m_data.data(), sub.m_data.data(), U);
+		return *this;
+	}
+
+	constexpr FixedUInt operator-(FixedUInt const& sub) const {
+		FixedUInt temp{*this};
+		temp -= sub;
+		return temp;
+	}
+
+	constexpr FixedUInt operator-() const {
+		FixedUInt temp{};
+		limb_neg_n(temp.m_data.data(), m_data.data(), U);
+		return temp;
+	}
+
+	constexpr FixedUInt& operator++() {
+		*this += FixedUInt{1U};
+		return *this;
+	}
+
+	constexpr FixedUInt operator++(int) {
+		FixedUInt temp{*this};
+		*this += FixedUInt{1U};
+		return temp;
+	}
+
+	constexpr FixedUInt& operator--() {
+		*this -= FixedUInt{1U};
+		return *this;
+	}
+
+	constexpr FixedUInt operator--(int) {
+		FixedUInt temp{*this};
+		*this -= FixedUInt{1U};
+		return temp;
+	}
+
+	// Only the low U limbs of the product are computed
+	constexpr FixedUInt operator*(FixedUInt const& mult) const {
+		FixedUInt temp{};
+		limb_mul_lo_n(temp.m_data.data(), m_data.data(), mult.m_data.data(), U);
+		return temp;
+	}
+
+	constexpr FixedUInt& operator*=(FixedUInt const& mult) {
+		auto temp = operator*(mult);
+		m_data.swap(temp.m_data);
+		return *this;
+	}
+
+// Bitshift operators, these are logical shifts
+	constexpr FixedUInt& operator<<=(std::size_t const& val) {
+		std::size_t word_offset = val >> 5;
+		std::size_t bit_offset = val & 0x1F;
+		for(std::size_t idx = U; idx > 0; idx--) {
+			std::uint64_t buff = 0;
+			if((idx - 1) >= word_offset) {
+				buff = (std::uint64_t)m_data[(idx - 1) - word_offset] << bit_offset;
+				if((idx - 1) > word_offset) {
+					buff ^= ((std::uint64_t)m_data[(idx - 2) - word_offset] << bit_offset) >> 32;
+				}
+			}
+			m_data[idx - 1] = buff & 0xFFFFFFFF;
+		}
+		return *this;
+	}
+
+	constexpr FixedUInt operator<<(std::size_t const& val) const {
+		FixedUInt temp{*this};
+		temp <<= val;
+		return temp;
+	}
+
+	constexpr FixedUInt& operator>>=(std::size_t const& val) {
+		std::size_t word_offset = val >> 5;
+		std::size_t bit_offset = val & 0x1F;
+		for(std::size_t idx = 0; idx < U; idx++) {
+			std::uint64_t buff = 0;
+			if((idx + word_offset) < U) {
+				buff = m_data[idx + word_offset];
+				if((idx + word_offset + 1) < U) {
+					buff ^= (std::uint64_t)m_data[idx + word_offset + 1] << 32;
+				}
+			}
+			m_data[idx] = (buff >> bit_offset) & 0xFFFFFFFF;
+		}
+		return *this;
+	}
+
+	constexpr FixedUInt operator>>(std::size_t const& val) const {
+		FixedUInt temp{*this};
+		temp >>= val;
+		return temp;
+	}
+
+// Bitwise Operators
+	constexpr FixedUInt& operator&=(FixedUInt const& other) {
+		for(std::size_t idx = 0; idx < U; idx++) {
+			m_data[idx] &= other.m_data[idx];
+		}
+		return *this;
+	}
+
+	constexpr FixedUInt operator&(FixedUInt const& other) const {
+		FixedUInt temp{*this};
+		temp &= other;
+		return temp;
+	}
+
+	constexpr FixedUInt& operator^=(FixedUInt const& other) {
+		for(std::size_t idx = 0; idx < U; idx++) {
+			m_data[idx] ^= other.m_data[idx];
+		}
+		return *this;
+	}
+
+	constexpr FixedUInt operator^(FixedUInt const& other) const {
+		FixedUInt temp{*this};
+		temp ^= other;
+		return temp;
+	}
+
+	constexpr FixedUInt& operator|=(FixedUInt const& other) {
+		for(std::size_t idx = 0; idx < U; idx++) {
+			m_data[idx] |= other.m_data[idx];
+		}
+		return *this;
+	}
+
+	constexpr FixedUInt operator|(FixedUInt const& other) const {
+		FixedUInt temp{*this};
+		temp |= other;
+		return temp;
+	}
+
+	constexpr FixedUInt operator~() const {
+		FixedUInt temp{*this};
+		for(auto& v : temp.m_data) {
+			v = ~v;
+		}
+		return temp;
+	}
+
+	friend std::ostream& operator<<(std::ostream& os, FixedUInt const& num) {
+		os << static_cast<FixedBigNum<U>>(num);
+		return os;
+	}
+
+private:
+	template<std::size_t>
+	friend struct FixedUInt;
+
+	std::array<std::uint32_t, U> m_data; // The number data itself, least significant limb first
+};
+
+using uint1024 = FixedUInt<32>;
+
+#endif // FIXED_UINT_H_3B8F0E6D5C2A4F1E9D7B6A5C4E3F2D1B
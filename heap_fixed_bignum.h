@@ -0,0 +1,303 @@
+/*
+ * File:      heap_fixed_bignum.h
+ * Author:    Daniel Hannon
+ *
+ * Copyright: 2024 Daniel Hannon
+ */
+
+#ifndef HEAP_FIXED_BIGNUM_H_5E0B7A93C1D24F68A4B2E9C7D1F3A608
+#define HEAP_FIXED_BIGNUM_H_5E0B7A93C1D24F68A4B2E9C7D1F3A608 1
+
+#include "arbitrary_bignum.h"
+#include "fixed_bignum.h"
+#include "limb_kernels.h"
+#include "util.h"
+
+#include <algorithm>
+#include <bit>
+#include <compare>
+#include <memory>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * HeapFixedBigNum behaves like FixedBigNum<U> (sign-magnitude, truncated
+ * to U limbs) but keeps its limbs in a heap buffer, so the object itself is
+ * a pointer and two words. Nothing it does puts a U sized array on the
+ * stack, which makes very wide numbers safe on threads with small stacks.
+ * Moves just hand over the buffer, products are built in a per-thread
+ * scratch buffer that is reused from one operation to the next.
+ *
+ * A moved-from HeapFixedBigNum can only be assigned to or destroyed.
+ */
+template<std::size_t U>
+struct HeapFixedBigNum {
+	static_assert(U != 0, "You cant have a 0 limb number");
+
+	HeapFixedBigNum() : m_data{std::make_unique<std::uint32_t[]>(U)}, m_signed{false}, m_maxDigit{0}
+	{}
+
+	HeapFixedBigNum(std::integral auto x) : HeapFixedBigNum{}
+	{
+		std::uint64_t mag = static_cast<std::uint64_t>(x);
+		if constexpr(std::is_signed_v<decltype(x)>) {
+			if(x < 0) {
+				mag = (std::uint64_t)0 - mag;
+				m_signed = true;
+			}
+		}
+		m_data[0] = mag & 0xFFFFFFFF;
+		if constexpr(U > 1) {
+			m_data[1] = mag >> 32;
+		}
+		refresh_max_digit(std::min<std::size_t>(2, U));
+	}
+
+	template<std::size_t T>
+	explicit HeapFixedBigNum(FixedBigNum<T> const& x) : HeapFixedBigNum{}
+	{
+		std::copy_n(x.m_data.begin(), std::min(T, U), m_data.get());
+		m_signed = x.m_signed;
+		refresh_max_digit(std::min(T, U));
+	}
+
+	HeapFixedBigNum(HeapFixedBigNum const& x) : m_data{std::make_unique<std::uint32_t[]>(U)}, m_signed{x.m_signed}, m_maxDigit{x.m_maxDigit}
+	{
+		std::copy_n(x.m_data.get(), m_maxDigit + 1, m_data.get());
+	}
+
+	HeapFixedBigNum(HeapFixedBigNum&& x) noexcept : m_data{std::move(x.m_data)}, m_signed{x.m_signed}, m_maxDigit{x.m_maxDigit}
+	{}
+
+	HeapFixedBigNum& operator=(HeapFixedBigNum const& x) {
+		if(this != &x) {
+			if(!m_data) {
+				// Moved from, the buffer went with the move and comes back zeroed
+				m_data = std::make_unique<std::uint32_t[]>(U);
+			} else {
+				// Only the limbs that could be non-zero on either side need touching
+				std::fill_n(m_data.get(), m_maxDigit + 1, 0);
+			}
+			std::copy_n(x.m_data.get(), x.m_maxDigit + 1, m_data.get());
+			m_signed = x.m_signed;
+			m_maxDigit = x.m_maxDigit;
+		}
+		return *this;
+	}
+
+	HeapFixedBigNum& operator=(HeapFixedBigNum&& x) noexcept {
+		m_data.swap(x.m_data);
+		std::swap(m_signed, x.m_signed);
+		std::swap(m_maxDigit, x.m_maxDigit);
+		return *this;
+	}
+
+	// This puts a FixedBigNum<T> on the stack, so only use it for T that fit there
+	template<std::size_t T>
+	explicit operator FixedBigNum<T>() const {
+		FixedBigNum<T> result{0};
+		std::copy_n(m_data.get(), std::min(m_maxDigit + 1, T), result.m_data.begin());
+		result.m_maxDigit = result.get_most_populated();
+		result.m_signed = m_signed && !result.is_zero();
+		return result;
+	}
+
+// Comparators
+	std::strong_ordering operator<=>(HeapFixedBigNum const& vs) const {
+		if(auto signs = vs.m_signed <=> m_signed; signs != 0) {
+			return signs;
+		}
+		auto res = compare_magnitude(vs);
+		return m_signed ? (0 <=> res) : (res <=> 0);
+	}
+
+	bool operator==(HeapFixedBigNum const& cmp) const {
+		return std::is_eq(*this <=> cmp);
+	}
+
+// Arithmetic
+	HeapFixedBigNum& operator+=(HeapFixedBigNum const& add) {
+		add_signed(add, false);
+		return *this;
+	}
+
+	HeapFixedBigNum operator+(HeapFixedBigNum const& add) const {
+		HeapFixedBigNum temp{*this};
+		temp += add;
+		return temp;
+	}
+
+	HeapFixedBigNum& operator-=(HeapFixedBigNum const& sub) {
+		if(&sub == this) {
+			set_zero();
+			return *this;
+		}
+		add_signed(sub, true);
+		return *this;
+	}
+
+	HeapFixedBigNum operator-(HeapFixedBigNum const& sub) const {
+		HeapFixedBigNum temp{*this};
+		temp -= sub;
+		return temp;
+	}
+
+	HeapFixedBigNum& operator*=(HeapFixedBigNum const& mult) {
+		if(is_zero() || mult.is_zero()) {
+			set_zero();
+			return *this;
+		}
+		std::size_t lhsLen = m_maxDigit + 1;
+		std::size_t rhsLen = mult.m_maxDigit + 1;
+		std::uint32_t* product = scratch(lhsLen + rhsLen);
+		limb_mul_basecase(product, m_data.get(), lhsLen, mult.m_data.get(), rhsLen);
+		std::size_t kept = std::min(lhsLen + rhsLen, U);
+		std::copy_n(product, kept, m_data.get());
+		m_signed = (m_signed != mult.m_signed);
+		refresh_max_digit(kept);
+		return *this;
+	}
+
+	HeapFixedBigNum operator*(HeapFixedBigNum const& mult) const {
+		HeapFixedBigNum temp{*this};
+		temp *= mult;
+		return temp;
+	}
+
+	HeapFixedBigNum& operator*=(std::uint32_t mult) {
+		std::size_t len = m_maxDigit + 1;
+		auto carry = limb_mul_1_add(m_data.get(), len, mult, 0);
+		if(len < U) {
+			m_data[len] = carry;
+		}
+		refresh_max_digit(std::min(len + 1, U));
+		return *this;
+	}
+
+	HeapFixedBigNum& operator+=(std::uint32_t add) {
+		std::size_t len = m_maxDigit + 1;
+		if(!m_signed) {
+			auto carry = limb_add_1(m_data.get(), len, add);
+			if(len < U) {
+				m_data[len] = carry;
+			}
+			refresh_max_digit(std::min(len + 1, U));
+		} else if((m_maxDigit != 0) || (m_data[0] >= add)) {
+			// The magnitude only shrinks, a zero result drops the sign
+			limb_sub_1(m_data.get(), len, add);
+			refresh_max_digit(len);
+		} else {
+			m_data[0] = add - m_data[0];
+			m_signed = false;
+		}
+		return *this;
+	}
+
+	// Divides the magnitude in place, returns the magnitude of the remainder
+	std::uint32_t divmod(std::uint32_t div) {
+		if(div == 0) {
+			set_zero();
+			return 0;
+		}
+		auto rem = limb_divmod_1(m_data.get(), m_maxDigit + 1, div);
+		refresh_max_digit(m_maxDigit + 1);
+		return rem;
+	}
+
+// Bit queries
+	std::size_t bit_width() const {
+		return (m_maxDigit * 32) + std::bit_width(m_data[m_maxDigit]);
+	}
+
+	friend std::ostream& operator<<(std::ostream& os, HeapFixedBigNum const& num) {
+		os << num.to_printable();
+		return os;
+	}
+
+	friend HeapFixedBigNum abs(HeapFixedBigNum const& num) {
+		HeapFixedBigNum tmp{num};
+		tmp.m_signed = false;
+		return tmp;
+	}
+
+	friend bool signbit(HeapFixedBigNum const& num) {
+		return num.m_signed;
+	}
+
+private:
+	bool is_zero() const {
+		return (m_maxDigit == 0) && (m_data[0] == 0);
+	}
+
+	ArbitraryBigNum<ARBITRARY_PRINTABLE> to_printable() const {
+		return ArbitraryBigNum<ARBITRARY_PRINTABLE>{m_data.get(), m_maxDigit + 1, m_signed};
+	}
+
+	// Clears the limbs that can be non-zero rather than allocating a new zero
+	void set_zero() {
+		std::fill_n(m_data.get(), m_maxDigit + 1, 0);
+		m_signed = false;
+		m_maxDigit = 0;
+	}
+
+	// Finds the top non-zero limb, every limb from len upwards must already be 0
+	void refresh_max_digit(std::size_t len) {
+		m_maxDigit = std::max<std::size_t>(limb_active_length(m_data.get(), len), 1) - 1;
+		if(is_zero()) {
+			m_signed = false;
+		}
+	}
+
+	std::strong_ordering compare_magnitude(HeapFixedBigNum const& other) const {
+		if(auto width = m_maxDigit <=> other.m_maxDigit; width != 0) {
+			return width;
+		}
+		for(std::size_t idx = m_maxDigit + 1; idx > 0; idx--) {
+			if(auto res = m_data[idx - 1] <=> other.m_data[idx - 1]; res != 0) return res;
+		}
+		return std::strong_ordering::equal;
+	}
+
+	// this += other (or -= when negate is set), straight on the heap limbs
+	void add_signed(HeapFixedBigNum const& other, bool negate) {
+		bool otherSign = other.m_signed != negate;
+		std::size_t len = std::max(m_maxDigit, other.m_maxDigit) + 1;
+		if(is_zero()) {
+			m_signed = otherSign;
+		}
+		if(m_signed == otherSign) {
+			auto carry = limb_add_n(m_data.get(), m_data.get(), other.m_data.get(), len);
+			if(len < U) {
+				m_data[len] = carry;
+			}
+			refresh_max_digit(std::min(len + 1, U));
+		} else if(compare_magnitude(other) != std::strong_ordering::less) {
+			limb_sub_n(m_data.get(), m_data.get(), other.m_data.get(), len);
+			refresh_max_digit(len);
+		} else {
+			limb_sub_n(m_data.get(), other.m_data.get(), m_data.get(), len);
+			m_signed = otherSign;
+			refresh_max_digit(len);
+		}
+	}
+
+	// Per-thread scratch space, it only ever grows so repeated products reuse it
+	static std::uint32_t* scratch(std::size_t len) {
+		thread_local std::vector<std::uint32_t> buffer;
+		if(buffer.size() < len) {
+			buffer.resize(len);
+		}
+		return buffer.data();
+	}
+
+private:
+	std::unique_ptr<std::uint32_t[]> m_data;	 // U limbs, least significant first
+	bool							 m_signed;	 // The sign for the number
+	std::size_t						 m_maxDigit; // The Maximum Occupied digit
+};
+
+#endif // HEAP_FIXED_BIGNUM_H_5E0B7A93C1D24F68A4B2E9C7D1F3A608
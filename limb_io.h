@@ -0,0 +1,117 @@
+/*
+ * File:      limb_io.h
+ * Author:    Daniel Hannon
+ *
+ * Copyright: 2024 Daniel Hannon
+ */
+
+#ifndef LIMB_IO_H_0D6F2B8E4A1C4E37B95A7C3E8F1D2B60
+#define LIMB_IO_H_0D6F2B8E4A1C4E37B95A7C3E8F1D2B60 1
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * Moves the binary limbs of a number in and out of arrays of 8, 16, 32
+ * or 64 bit words. The layout options are the same as GMP's mpz_import
+ * and mpz_export: the words can go least or most significant first and
+ * each word can be stored in either byte order. Only the magnitude is
+ * transferred, signs are up to the caller.
+ */
+
+// Which end of the array holds the least significant word
+enum class WordOrder {
+	least_significant_first,
+	most_significant_first,
+};
+
+template<typename W>
+concept limb_word = std::unsigned_integral<W> && !std::same_as<W, bool> && (sizeof(W) <= 8);
+
+template<limb_word W>
+constexpr W word_byteswap(W word) {
+	W swapped = 0;
+	for(std::size_t idx = 0; idx < sizeof(W); idx++) {
+		swapped = (W)((swapped << 8) | (word & 0xFF));
+		word = (W)(word >> 8);
+	}
+	return swapped;
+}
+
+// Number of W words needed for the len limbs at data, 0 for 0
+template<limb_word W>
+constexpr std::size_t limb_word_count(std::uint32_t const* data, std::size_t len) {
+	while((len != 0) && (data[len - 1] == 0)) {
+		len--;
+	}
+	if(len == 0) return 0;
+	std::size_t bits = ((len - 1) * 32) + std::bit_width(data[len - 1]);
+	return (bits + (8 * sizeof(W)) - 1) / (8 * sizeof(W));
+}
+
+// Writes the value in limbs[0..len) to out[0..count), zero padded and truncated to count words
+template<limb_word W>
+constexpr void limb_export_words(W* out, std::size_t count, std::uint32_t const* limbs, std::size_t len, WordOrder order, std::endian endian) {
+	constexpr std::size_t bits = 8 * sizeof(W);
+	bool swap = (endian != std::endian::native) && (sizeof(W) > 1);
+	bool reverse = (order == WordOrder::most_significant_first);
+	if constexpr(bits == 32) {
+		// Same layout as the limbs, this is a straight copy
+		if(!swap && !reverse) {
+			std::size_t copied = std::min(count, len);
+			std::copy_n(limbs, copied, out);
+			std::fill(out + copied, out + count, 0);
+			return;
+		}
+	}
+	auto limb = [&](std::size_t idx) -> std::uint64_t {
+		return (idx < len) ? limbs[idx] : 0;
+	};
+	for(std::size_t idx = 0; idx < count; idx++) {
+		std::uint64_t value = 0;
+		if constexpr(bits == 64) {
+			value = limb(2 * idx) | (limb((2 * idx) + 1) << 32);
+		} else {
+			constexpr std::size_t perLimb = 32 / bits;
+			value = limb(idx / perLimb) >> (bits * (idx % perLimb));
+		}
+		W word = (W)value;
+		out[reverse ? (count - 1 - idx) : idx] = swap ? word_byteswap(word) : word;
+	}
+}
+
+// Reads words[0..count) into limbs[0..len), anything that does not fit in len limbs is dropped
+template<limb_word W>
+constexpr void limb_import_words(std::uint32_t* limbs, std::size_t len, W const* words, std::size_t count, WordOrder order, std::endian endian) {
+	constexpr std::size_t bits = 8 * sizeof(W);
+	bool swap = (endian != std::endian::native) && (sizeof(W) > 1);
+	bool reverse = (order == WordOrder::most_significant_first);
+	if constexpr(bits == 32) {
+		if(!swap && !reverse) {
+			std::size_t copied = std::min(count, len);
+			std::copy_n(words, copied, limbs);
+			std::fill(limbs + copied, limbs + len, 0);
+			return;
+		}
+	}
+	std::fill(limbs, limbs + len, 0);
+	for(std::size_t idx = 0; idx < count; idx++) {
+		W word = words[reverse ? (count - 1 - idx) : idx];
+		std::uint64_t value = swap ? word_byteswap(word) : word;
+		if constexpr(bits == 64) {
+			if((2 * idx) < len) limbs[2 * idx] = value & 0xFFFFFFFF;
+			if(((2 * idx) + 1) < len) limbs[(2 * idx) + 1] = value >> 32;
+		} else {
+			constexpr std::size_t perLimb = 32 / bits;
+			if((idx / perLimb) < len) {
+				limbs[idx / perLimb] |= (std::uint32_t)(value << (bits * (idx % perLimb)));
+			}
+		}
+	}
+}
+
+#endif // LIMB_IO_H_0D6F2B8E4A1C4E37B95A7C3E8F1D2B60
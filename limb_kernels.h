@@ -0,0 +1,897 @@
+/*
+ * File:      limb_kernels.h
+ * Author:    Daniel Hannon
+ *
+ * Copyright: 2024 Daniel Hannon
+ *
+ * Brief: Loops over raw little-endian arrays of 32-bit limbs that are
+ * shared between the big number types.
+ */
+
+#ifndef LIMB_KERNELS_H_7D2C9A41E0B34F6B8E51C3A9F04D2B17
+#define LIMB_KERNELS_H_7D2C9A41E0B34F6B8E51C3A9F04D2B17 1
+
+#include <algorithm>
+#include <bit>
+#include <type_traits>
+#include <utility>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// The 64 bit word kernels below need a 64x64->128 multiply, MULX/ADCX/ADOX are
+// used when the target has them (-mbmi2 -madx) and __int128 otherwise.
+#if defined(__x86_64__) && defined(__BMI2__) && defined(__ADX__)
+#include <immintrin.h>
+#define LIMB_KERNELS_ADX 1
+#endif
+
+#if defined(LIMB_KERNELS_ADX) || defined(__SIZEOF_INT128__)
+#define LIMB_KERNELS_WORDS 1
+#endif
+
+// The batched remainder kernel runs four moduli per AVX register when it can
+#if defined(__x86_64__) && defined(__AVX__)
+#include <immintrin.h>
+#define LIMB_KERNELS_AVX 1
+#endif
+
+// Carry-less products use PCLMULQDQ when the target has it (-mpclmul)
+#if defined(__x86_64__) && defined(__PCLMUL__) && defined(__SSE4_1__)
+#include <immintrin.h>
+#define LIMB_KERNELS_CLMUL 1
+#endif
+
+// Length of the limb array once leading zero limbs are dropped, 0 if the value is zero.
+constexpr std::size_t limb_active_length(std::uint32_t const* data, std::size_t len) {
+	while((len != 0) && (data[len - 1] == 0)) {
+		len--;
+	}
+	return len;
+}
+
+// data = data * mult + add, returns the limb that carried out of the top.
+constexpr std::uint32_t limb_mul_1_add(std::uint32_t* data, std::size_t len, std::uint32_t mult, std::uint32_t add) {
+	std::uint64_t carry = add;
+	for(std::size_t idx = 0; idx < len; idx++) {
+		carry += (std::uint64_t)data[idx] * mult;
+		data[idx] = carry & 0xFFFFFFFF;
+		carry >>= 32;
+	}
+	return carry & 0xFFFFFFFF;
+}
+
+// res = lhs + rhs over n limbs, returns the carry out. res may alias either input.
+constexpr std::uint32_t limb_add_n(std::uint32_t* res, std::uint32_t const* lhs, std::uint32_t const* rhs, std::size_t n) {
+	std::uint64_t carry = 0;
+	for(std::size_t idx = 0; idx < n; idx++) {
+		carry += (std::uint64_t)lhs[idx] + rhs[idx];
+		res[idx] = carry & 0xFFFFFFFF;
+		carry >>= 32;
+	}
+	return carry & 0xFFFFFFFF;
+}
+
+// res = lhs - rhs over n limbs, returns the borrow out. res may alias either input.
+constexpr std::uint32_t limb_sub_n(std::uint32_t* res, std::uint32_t const* lhs, std::uint32_t const* rhs, std::size_t n) {
+	std::uint64_t borrow = 0;
+	for(std::size_t idx = 0; idx < n; idx++) {
+		std::uint64_t diff = (std::uint64_t)lhs[idx] - rhs[idx] - borrow;
+		res[idx] = diff & 0xFFFFFFFF;
+		// A wrapped subtraction sets the top bit
+		borrow = diff >> 63;
+	}
+	return borrow & 0xFFFFFFFF;
+}
+
+// res = -data mod 2^(32n), returns 1 unless data was 0. res may alias data.
+constexpr std::uint32_t limb_neg_n(std::uint32_t* res, std::uint32_t const* data, std::size_t n) {
+	std::uint64_t borrow = 0;
+	for(std::size_t idx = 0; idx < n; idx++) {
+		std::uint64_t diff = 0 - (std::uint64_t)data[idx] - borrow;
+		res[idx] = diff & 0xFFFFFFFF;
+		borrow = diff >> 63;
+	}
+	return borrow & 0xFFFFFFFF;
+}
+
+// res += data * mult over n limbs, returns the limb that carried out of the top.
+constexpr std::uint32_t limb_addmul_1(std::uint32_t* res, std::uint32_t const* data, std::size_t n, std::uint32_t mult) {
+	std::uint64_t carry = 0;
+	for(std::size_t idx = 0; idx < n; idx++) {
+		carry += ((std::uint64_t)data[idx] * mult) + res[idx];
+		res[idx] = carry & 0xFFFFFFFF;
+		carry >>= 32;
+	}
+	return carry & 0xFFFFFFFF;
+}
+
+// res = (lhs * rhs) mod 2^(32n), res must not alias either input.
+constexpr void limb_mul_lo_n(std::uint32_t* res, std::uint32_t const* lhs, std::uint32_t const* rhs, std::size_t n) {
+	for(std::size_t idx = 0; idx < n; idx++) {
+		res[idx] = 0;
+	}
+	for(std::size_t idx = 0; idx < n; idx++) {
+		if(lhs[idx] == 0) continue;
+		limb_addmul_1(res + idx, rhs, n - idx, lhs[idx]);
+	}
+}
+
+// Adds val at data[0] and ripples the carry through len limbs, returns the carry out of the top.
+constexpr std::uint32_t limb_add_1(std::uint32_t* data, std::size_t len, std::uint32_t val) {
+	std::uint64_t carry = val;
+	for(std::size_t idx = 0; (idx < len) && (carry != 0); idx++) {
+		carry += data[idx];
+		data[idx] = carry & 0xFFFFFFFF;
+		carry >>= 32;
+	}
+	return carry & 0xFFFFFFFF;
+}
+
+#ifdef LIMB_KERNELS_WORDS
+/*
+ * 64 bit word kernels, a "word" is two neighbouring 32 bit limbs read as one
+ * little-endian value. The pointers still point at 32 bit limbs and every
+ * length is a count of words.
+ */
+inline std::uint64_t word_load(std::uint32_t const* data, std::size_t word) {
+	return (std::uint64_t)data[2 * word] | ((std::uint64_t)data[(2 * word) + 1] << 32);
+}
+
+inline void word_store(std::uint32_t* data, std::size_t word, std::uint64_t val) {
+	data[2 * word] = val & 0xFFFFFFFF;
+	data[(2 * word) + 1] = val >> 32;
+}
+
+// Full 64x64 bit product, returns the low word
+inline std::uint64_t word_mul(std::uint64_t lhs, std::uint64_t rhs, std::uint64_t& high) {
+#ifdef LIMB_KERNELS_ADX
+	unsigned long long hi;
+	std::uint64_t lo = _mulx_u64(lhs, rhs, &hi);
+	high = hi;
+	return lo;
+#else
+	unsigned __int128 product = (unsigned __int128)lhs * rhs;
+	high = (std::uint64_t)(product >> 64);
+	return (std::uint64_t)product;
+#endif
+}
+
+// res = data * mult over n words, returns the word carried out of the top
+inline std::uint64_t word_mul_1(std::uint32_t* res, std::uint32_t const* data, std::size_t n, std::uint64_t mult) {
+	std::uint64_t carry = 0;
+	for(std::size_t idx = 0; idx < n; idx++) {
+		std::uint64_t high;
+		std::uint64_t low = word_mul(word_load(data, idx), mult, high);
+		low += carry;
+		carry = high + (low < carry);
+		word_store(res, idx, low);
+	}
+	return carry;
+}
+
+// res += data * mult over n words, returns the word carried out of the top.
+// The low halves and the previous high half go through two separate carry
+// chains (ADCX and ADOX) so neither add waits on the other.
+inline std::uint64_t word_addmul_1(std::uint32_t* res, std::uint32_t const* data, std::size_t n, std::uint64_t mult) {
+	std::uint64_t prevHigh = 0;
+#ifdef LIMB_KERNELS_ADX
+	unsigned char lowCarry = 0;
+	unsigned char highCarry = 0;
+	for(std::size_t idx = 0; idx < n; idx++) {
+		std::uint64_t high;
+		std::uint64_t low = word_mul(word_load(data, idx), mult, high);
+		unsigned long long sum;
+		lowCarry = _addcarryx_u64(lowCarry, word_load(res, idx), low, &sum);
+		highCarry = _addcarryx_u64(highCarry, sum, prevHigh, &sum);
+		word_store(res, idx, sum);
+		prevHigh = high;
+	}
+	return prevHigh + lowCarry + highCarry;
+#else
+	for(std::size_t idx = 0; idx < n; idx++) {
+		unsigned __int128 sum = (unsigned __int128)word_load(data, idx) * mult;
+		sum += word_load(res, idx);
+		sum += prevHigh;
+		word_store(res, idx, (std::uint64_t)sum);
+		prevHigh = (std::uint64_t)(sum >> 64);
+	}
+	return prevHigh;
+#endif
+}
+
+// Adds val at word 0 and ripples the carry through len words, returns the carry out
+inline std::uint64_t word_add_1(std::uint32_t* data, std::size_t len, std::uint64_t val) {
+	for(std::size_t idx = 0; (idx < len) && (val != 0); idx++) {
+		std::uint64_t sum = word_load(data, idx) + val;
+		val = (sum < val);
+		word_store(data, idx, sum);
+	}
+	return val;
+}
+
+// out = lhs + rhs + carry, returns the carry out. With ADX this is a single ADCX
+// or ADOX, so two independent chains of these can run side by side.
+inline unsigned char word_add_carry(unsigned char carry, std::uint64_t lhs, std::uint64_t rhs, std::uint64_t& out) {
+#ifdef LIMB_KERNELS_ADX
+	unsigned long long sum;
+	carry = _addcarryx_u64(carry, lhs, rhs, &sum);
+	out = sum;
+	return carry;
+#else
+	std::uint64_t sum = lhs + rhs;
+	unsigned char overflow = (sum < lhs);
+	out = sum + carry;
+	return overflow | (out < sum);
+#endif
+}
+
+// p[I..I+5) += a[0..4) * mult with p[I+4] zero on entry. The first carry chain folds
+// each product high half into the next low half, the second adds that row into p.
+template<std::size_t I>
+inline void word_mul_row_4x4(std::uint64_t* p, std::uint64_t const* a, std::uint64_t mult) {
+	std::uint64_t low[4];
+	std::uint64_t high[4];
+	unsigned char rowCarry = 0;
+	unsigned char accCarry = 0;
+	[&]<std::size_t... J>(std::index_sequence<J...>) {
+		((low[J] = word_mul(a[J], mult, high[J])), ...);
+	}(std::make_index_sequence<4>{});
+	accCarry = word_add_carry(accCarry, p[I], low[0], p[I]);
+	[&]<std::size_t... J>(std::index_sequence<J...>) {
+		std::uint64_t sum = 0;
+		((rowCarry = word_add_carry(rowCarry, low[J + 1], high[J], sum), accCarry = word_add_carry(accCarry, p[I + J + 1], sum, p[I + J + 1])), ...);
+	}(std::make_index_sequence<3>{});
+	// p[0..I+5) holds a * rhs[0..I], which always fits, so this can't carry out
+	p[I + 4] = high[3] + rowCarry + accCarry;
+}
+
+// res[0..8) += lhs[0..4) * rhs[0..4), fully unrolled. The 4x4 product is built in
+// registers a row at a time with word_mul_row_4x4 and then added to res in a
+// single pass. Returns the carry out of res[7].
+inline std::uint64_t word_addmul_4x4(std::uint32_t* res, std::uint32_t const* lhs, std::uint32_t const* rhs) {
+	std::uint64_t a[4];
+	std::uint64_t p[8] = {};
+	unsigned char carry = 0;
+	[&]<std::size_t... I>(std::index_sequence<I...>) {
+		((a[I] = word_load(lhs, I)), ...);
+		(word_mul_row_4x4<I>(p, a, word_load(rhs, I)), ...);
+	}(std::make_index_sequence<4>{});
+	[&]<std::size_t... K>(std::index_sequence<K...>) {
+		std::uint64_t sum = 0;
+		((carry = word_add_carry(carry, word_load(res, K), p[K], sum), word_store(res, K, sum)), ...);
+	}(std::make_index_sequence<8>{});
+	return carry;
+}
+
+// res[0..lhsLen+rhsLen) = lhs * rhs in words, res must not alias either input.
+// Full 4x4 blocks go through word_addmul_4x4 and the ragged edges through word_addmul_1.
+inline void word_mul_basecase(std::uint32_t* res, std::uint32_t const* lhs, std::size_t lhsLen, std::uint32_t const* rhs, std::size_t rhsLen) {
+	std::size_t total = lhsLen + rhsLen;
+	for(std::size_t idx = 0; idx < total; idx++) {
+		word_store(res, idx, 0);
+	}
+
+	std::size_t row = 0;
+	for(; (row + 4) <= rhsLen; row += 4) {
+		std::size_t col = 0;
+		for(; (col + 4) <= lhsLen; col += 4) {
+			auto carry = word_addmul_4x4(res + (2 * (row + col)), lhs + (2 * col), rhs + (2 * row));
+			word_add_1(res + (2 * (row + col + 8)), total - (row + col + 8), carry);
+		}
+		for(std::size_t idx = 0; (idx < 4) && (col < lhsLen); idx++) {
+			auto carry = word_addmul_1(res + (2 * (row + col + idx)), lhs + (2 * col), lhsLen - col, word_load(rhs, row + idx));
+			word_add_1(res + (2 * (row + lhsLen + idx)), total - (row + lhsLen + idx), carry);
+		}
+	}
+	for(; row < rhsLen; row++) {
+		auto carry = word_addmul_1(res + (2 * row), lhs, lhsLen, word_load(rhs, row));
+		word_add_1(res + (2 * (row + lhsLen)), total - (row + lhsLen), carry);
+	}
+}
+
+// res[I..W) += lhs[0..W-I) * mult on 64 bit words, the carry out of the top is dropped
+template<std::size_t W, std::size_t I>
+inline void word_addmul_row_fixed(std::uint64_t* res, std::uint64_t const* lhs, std::uint64_t mult) {
+	std::uint64_t carry = 0;
+	[&]<std::size_t... J>(std::index_sequence<J...>) {
+		std::uint64_t high = 0;
+		std::uint64_t low = 0;
+		((low = word_mul(lhs[J], mult, high), low += carry, high += (low < carry), low += res[I + J], high += (low < res[I + J]), res[I + J] = low, carry = high), ...);
+	}(std::make_index_sequence<W - I>{});
+}
+
+// Low W words of the product of two W word numbers held as 2W limbs each
+template<std::size_t W>
+inline void word_mul_lo_fixed(std::uint32_t* res, std::uint32_t const* lhs, std::uint32_t const* rhs) {
+	std::uint64_t lhsWords[W];
+	std::uint64_t rhsWords[W];
+	std::uint64_t resWords[W];
+	[&]<std::size_t... I>(std::index_sequence<I...>) {
+		((lhsWords[I] = word_load(lhs, I), rhsWords[I] = word_load(rhs, I), resWords[I] = 0), ...);
+		(word_addmul_row_fixed<W, I>(resWords, lhsWords, rhsWords[I]), ...);
+		(word_store(res, I, resWords[I]), ...);
+	}(std::make_index_sequence<W>{});
+}
+#endif // LIMB_KERNELS_WORDS
+
+/*
+ * Fixed length kernels for the small widths (int128 up to int1024). N is a
+ * template parameter and every loop is a fold over an index_sequence, so
+ * the compiler unrolls them completely and nothing branches on the data.
+ * They always do the work for all N limbs, which is cheaper than tracking
+ * the active length when N is small.
+ */
+
+// res = lhs + rhs over N limbs, returns the carry out. res may alias either input.
+template<std::size_t N>
+constexpr std::uint32_t limb_add_fixed(std::uint32_t* res, std::uint32_t const* lhs, std::uint32_t const* rhs) {
+	std::uint64_t carry = 0;
+	[&]<std::size_t... I>(std::index_sequence<I...>) {
+		((carry += (std::uint64_t)lhs[I] + rhs[I], res[I] = (std::uint32_t)carry, carry >>= 32), ...);
+	}(std::make_index_sequence<N>{});
+	return (std::uint32_t)carry;
+}
+
+// res = lhs - rhs over N limbs, returns the borrow out. res may alias either input.
+template<std::size_t N>
+constexpr std::uint32_t limb_sub_fixed(std::uint32_t* res, std::uint32_t const* lhs, std::uint32_t const* rhs) {
+	std::uint64_t borrow = 0;
+	[&]<std::size_t... I>(std::index_sequence<I...>) {
+		std::uint64_t diff = 0;
+		((diff = (std::uint64_t)lhs[I] - rhs[I] - borrow, res[I] = (std::uint32_t)diff, borrow = diff >> 63), ...);
+	}(std::make_index_sequence<N>{});
+	return (std::uint32_t)borrow;
+}
+
+// res[I..N) += lhs[0..N-I) * mult, the carry out of the top is dropped
+template<std::size_t N, std::size_t I>
+constexpr void limb_addmul_row_fixed(std::uint32_t* res, std::uint32_t const* lhs, std::uint32_t mult) {
+	std::uint64_t carry = 0;
+	[&]<std::size_t... J>(std::index_sequence<J...>) {
+		((carry += ((std::uint64_t)lhs[J] * mult) + res[I + J], res[I + J] = (std::uint32_t)carry, carry >>= 32), ...);
+	}(std::make_index_sequence<N - I>{});
+}
+
+// res = (lhs * rhs) mod 2^(32N), res must not alias either input. Even
+// widths run on 64 bit words, which is a quarter of the multiplies
+template<std::size_t N>
+constexpr void limb_mul_lo_fixed(std::uint32_t* res, std::uint32_t const* lhs, std::uint32_t const* rhs) {
+#ifdef LIMB_KERNELS_WORDS
+	if constexpr((N % 2) == 0) {
+		if(!std::is_constant_evaluated()) {
+			word_mul_lo_fixed<N / 2>(res, lhs, rhs);
+			return;
+		}
+	}
+#endif
+	[&]<std::size_t... I>(std::index_sequence<I...>) {
+		((res[I] = 0), ...);
+		(limb_addmul_row_fixed<N, I>(res, lhs, rhs[I]), ...);
+	}(std::make_index_sequence<N>{});
+}
+
+// res = |lhs - rhs| over N limbs, returns 1 if rhs was the larger one. The
+// difference is negated back with a mask instead of comparing first, so this
+// is two straight passes. res may alias either input.
+template<std::size_t N>
+constexpr std::uint32_t limb_sub_abs_fixed(std::uint32_t* res, std::uint32_t const* lhs, std::uint32_t const* rhs) {
+	std::uint32_t borrow = limb_sub_fixed<N>(res, lhs, rhs);
+	std::uint32_t mask = 0 - borrow;
+	std::uint64_t carry = borrow;
+	[&]<std::size_t... I>(std::index_sequence<I...>) {
+		((carry += res[I] ^ mask, res[I] = (std::uint32_t)carry, carry >>= 32), ...);
+	}(std::make_index_sequence<N>{});
+	return borrow;
+}
+
+// Index of the highest non-zero limb, 0 if every limb is zero
+template<std::size_t N>
+constexpr std::size_t limb_top_fixed(std::uint32_t const* data) {
+	std::size_t top = 0;
+	[&]<std::size_t... I>(std::index_sequence<I...>) {
+		((top = (data[I] != 0) ? I : top), ...);
+	}(std::make_index_sequence<N>{});
+	return top;
+}
+
+// res[0..lhsLen+rhsLen) = lhs * rhs, res must not alias either input.
+// This is the leaf every multiplication ends up in. At runtime the even
+// limb prefixes are multiplied as 64 bit words and an odd top limb on either
+// side is folded in afterwards with limb_addmul_1.
+constexpr void limb_mul_basecase(std::uint32_t* res, std::uint32_t const* lhs, std::size_t lhsLen, std::uint32_t const* rhs, std::size_t rhsLen) {
+	for(std::size_t idx = 0; idx < lhsLen + rhsLen; idx++) {
+		res[idx] = 0;
+	}
+#ifdef LIMB_KERNELS_WORDS
+	// Below 8 limbs on either side the word setup costs more than it saves
+	if(!std::is_constant_evaluated() && (lhsLen >= 8) && (rhsLen >= 8)) {
+		std::size_t lhsEven = lhsLen & ~(std::size_t)1;
+		std::size_t rhsEven = rhsLen & ~(std::size_t)1;
+		if((lhsEven != 0) && (rhsEven != 0)) {
+			word_mul_basecase(res, lhs, lhsEven / 2, rhs, rhsEven / 2);
+		}
+		if(rhsEven != rhsLen) {
+			auto carry = limb_addmul_1(res + rhsEven, lhs, lhsEven, rhs[rhsEven]);
+			limb_add_1(res + rhsEven + lhsEven, lhsLen + rhsLen - (rhsEven + lhsEven), carry);
+		}
+		if(lhsEven != lhsLen) {
+			auto carry = limb_addmul_1(res + lhsEven, rhs, rhsLen, lhs[lhsEven]);
+			limb_add_1(res + lhsEven + rhsLen, lhsLen + rhsLen - (lhsEven + rhsLen), carry);
+		}
+		return;
+	}
+#endif
+	for(std::size_t idx = 0; idx < rhsLen; idx++) {
+		res[idx + lhsLen] = limb_addmul_1(res + idx, lhs, lhsLen, rhs[idx]);
+	}
+}
+
+/*
+ * Short product, the top k limbs of the lhsLen + rhsLen limb product
+ * lhs * rhs. Partial products that land well below the kept limbs are never
+ * formed, which is close to half the work when k is half the product. The
+ * columns just below the kept limbs are still summed as guards, everything
+ * dropped beneath them adds up to less than one unit of the lowest kept
+ * limb, so the result is either exact or one below it.
+ *
+ * res needs k + 10 limbs. Returns the index in res of the lowest kept limb,
+ * the limbs under it are the guards. The saving only shows from about
+ * limb_mul_high_limbs limbs a side, below that the full product is as fast.
+ */
+inline constexpr std::size_t limb_mul_high_limbs = 32;
+
+constexpr std::size_t limb_mul_high(std::uint32_t* res, std::uint32_t const* lhs, std::size_t lhsLen, std::uint32_t const* rhs, std::size_t rhsLen, std::size_t k) {
+	std::size_t total = lhsLen + rhsLen;
+	std::size_t skip = total - std::min(k, total);
+#ifdef LIMB_KERNELS_WORDS
+	if(!std::is_constant_evaluated() && ((lhsLen % 2) == 0) && ((rhsLen % 2) == 0) && (lhsLen >= 8) && (rhsLen >= 8)) {
+		// Whole words only. A dropped word product reaches two limbs higher so
+		// every word product from word column guard up is summed, which keeps
+		// three or four guard limbs. The 4x4 blocks start up to three words
+		// under guard so none of them has to be split, res starts at low.
+		std::size_t guard = (skip > 3) ? ((skip - 3) / 2) : 0;
+		std::size_t low = (guard > 3) ? (guard - 3) : 0;
+		std::size_t base = 2 * low;
+		std::size_t width = total - base;
+		std::fill(res, res + width, 0);
+		std::size_t words = width / 2;
+		std::size_t lhsWords = lhsLen / 2;
+		std::size_t rhsWords = rhsLen / 2;
+		// res += lhs[from..lhsWords) * rhs[row], carried up to the top
+		auto addRow = [&](std::size_t row, std::size_t from) {
+			if(from >= lhsWords) return;
+			auto carry = word_addmul_1(res + (2 * (from + row - low)), lhs + (2 * from), lhsWords - from, word_load(rhs, row));
+			std::size_t top = lhsWords + row - low;
+			word_add_1(res + (2 * top), words - top, carry);
+		};
+		std::size_t row = 0;
+		for(; (row + 4) <= rhsWords; row += 4) {
+			std::size_t col = (guard > (row + 3)) ? (guard - row - 3) : 0;
+			for(; (col + 4) <= lhsWords; col += 4) {
+				std::size_t at = row + col - low;
+				auto carry = word_addmul_4x4(res + (2 * at), lhs + (2 * col), rhs + (2 * row));
+				word_add_1(res + (2 * (at + 8)), words - (at + 8), carry);
+			}
+			for(std::size_t idx = 0; idx < 4; idx++) {
+				addRow(row + idx, col);
+			}
+		}
+		for(; row < rhsWords; row++) {
+			addRow(row, (guard > row) ? (guard - row) : 0);
+		}
+		return skip - base;
+	}
+#endif
+	// Limb products reach one limb higher, two guard limbs cover them
+	std::size_t base = (skip > 2) ? (skip - 2) : 0;
+	std::size_t width = total - base;
+	for(std::size_t idx = 0; idx < width; idx++) {
+		res[idx] = 0;
+	}
+	for(std::size_t row = 0; row < rhsLen; row++) {
+		std::size_t first = (base > row) ? (base - row) : 0;
+		if(first >= lhsLen) continue;
+		auto carry = limb_addmul_1(res + (first + row) - base, lhs + first, lhsLen - first, rhs[row]);
+		std::size_t top = (lhsLen + row) - base;
+		limb_add_1(res + top, width - top, carry);
+	}
+	return skip - base;
+}
+
+// data = data / div in a single pass from the top limb down, returns data % div.
+constexpr std::uint32_t limb_divmod_1(std::uint32_t* data, std::size_t len, std::uint32_t div) {
+	std::uint64_t rem = 0;
+	for(std::size_t idx = len; idx > 0; idx--) {
+		rem = (rem << 32) | data[idx - 1];
+		data[idx - 1] = (rem / div) & 0xFFFFFFFF;
+		rem %= div;
+	}
+	return rem & 0xFFFFFFFF;
+}
+
+// res -= data * mult over n limbs, returns the limb that borrowed out of the top.
+constexpr std::uint32_t limb_submul_1(std::uint32_t* res, std::uint32_t const* data, std::size_t n, std::uint32_t mult) {
+	std::uint64_t borrow = 0;
+	for(std::size_t idx = 0; idx < n; idx++) {
+		std::uint64_t product = ((std::uint64_t)data[idx] * mult) + borrow;
+		std::uint64_t diff = (std::uint64_t)res[idx] - (product & 0xFFFFFFFF);
+		res[idx] = diff & 0xFFFFFFFF;
+		borrow = (product >> 32) + (diff >> 63);
+	}
+	return borrow & 0xFFFFFFFF;
+}
+
+// Subtracts val at data[0] and ripples the borrow through len limbs, returns the borrow out of the top.
+constexpr std::uint32_t limb_sub_1(std::uint32_t* data, std::size_t len, std::uint32_t val) {
+	std::uint64_t borrow = val;
+	for(std::size_t idx = 0; (idx < len) && (borrow != 0); idx++) {
+		std::uint64_t diff = (std::uint64_t)data[idx] - borrow;
+		data[idx] = diff & 0xFFFFFFFF;
+		borrow = diff >> 63;
+	}
+	return borrow & 0xFFFFFFFF;
+}
+
+// data >>= bits for bits < 32
+constexpr void limb_rshift(std::uint32_t* data, std::size_t len, std::uint32_t bits) {
+	if(bits == 0) return;
+	for(std::size_t idx = 0; idx < len; idx++) {
+		std::uint64_t buff = data[idx];
+		if((idx + 1) < len) {
+			buff |= (std::uint64_t)data[idx + 1] << 32;
+		}
+		data[idx] = (buff >> bits) & 0xFFFFFFFF;
+	}
+}
+
+// Inverse of an odd limb modulo 2^32. d * d == 1 mod 8 so d is right to 3 bits,
+// every Newton step doubles that.
+constexpr std::uint32_t limb_binvert_1(std::uint32_t d) {
+	std::uint32_t inv = d;
+	for(int step = 0; step < 4; step++) {
+		inv *= 2 - (d * inv);
+	}
+	return inv;
+}
+
+// res = data / div for an odd div that is known to divide data exactly. Works
+// from the bottom limb up, res may alias data.
+constexpr void limb_divexact_1(std::uint32_t* res, std::uint32_t const* data, std::size_t len, std::uint32_t div) {
+	std::uint32_t inv = limb_binvert_1(div);
+	std::uint64_t borrow = 0;
+	for(std::size_t idx = 0; idx < len; idx++) {
+		std::uint64_t diff = (std::uint64_t)data[idx] - borrow;
+		std::uint32_t quotient = (diff & 0xFFFFFFFF) * inv;
+		res[idx] = quotient;
+		borrow = (((std::uint64_t)quotient * div) >> 32) + (diff >> 63);
+	}
+}
+
+/*
+ * Exact (Jebelean/Hensel) division: res = num / div where div is known to
+ * divide num. The quotient is num * div^-1 mod 2^(32 qLen), so it is built
+ * from the low limb up with no trial quotients or remainder corrections and
+ * only the low qLen limbs of num and div are ever touched. If div does not
+ * divide num the result is garbage.
+ *
+ * num and div are clobbered (their common power of two is shifted out first),
+ * res needs numLen limbs and must not alias either. Returns the quotient length.
+ */
+constexpr std::size_t limb_divexact(std::uint32_t* res, std::uint32_t* num, std::size_t numLen, std::uint32_t* div, std::size_t divLen) {
+	numLen = limb_active_length(num, numLen);
+	divLen = limb_active_length(div, divLen);
+	std::size_t zeroLimbs = 0;
+	while((zeroLimbs < divLen) && (div[zeroLimbs] == 0)) {
+		zeroLimbs++;
+	}
+	if((divLen == 0) || (numLen <= zeroLimbs)) return 0;
+	std::uint32_t zeroBits = std::countr_zero(div[zeroLimbs]);
+	num += zeroLimbs;
+	div += zeroLimbs;
+	numLen -= zeroLimbs;
+	divLen -= zeroLimbs;
+	limb_rshift(num, numLen, zeroBits);
+	limb_rshift(div, divLen, zeroBits);
+	numLen = limb_active_length(num, numLen);
+	divLen = limb_active_length(div, divLen);
+	if(numLen < divLen) return 0;
+
+	std::size_t qLen = numLen - divLen + 1;
+	divLen = std::min(divLen, qLen);
+	if(divLen == 1) {
+		limb_divexact_1(res, num, qLen, div[0]);
+		return qLen;
+	}
+	std::uint32_t inv = limb_binvert_1(div[0]);
+	for(std::size_t idx = 0; idx < qLen; idx++) {
+		std::uint32_t quotient = num[idx] * inv;
+		res[idx] = quotient;
+		std::size_t span = std::min(divLen, qLen - idx);
+		auto borrow = limb_submul_1(num + idx, div, span, quotient);
+		limb_sub_1(num + idx + span, qLen - idx - span, borrow);
+	}
+	return qLen;
+}
+
+// data <<= bits for bits < 32, returns the bits shifted out of the top limb
+constexpr std::uint32_t limb_lshift(std::uint32_t* data, std::size_t len, std::uint32_t bits) {
+	if((bits == 0) || (len == 0)) return 0;
+	std::uint32_t out = data[len - 1] >> (32 - bits);
+	for(std::size_t idx = len - 1; idx > 0; idx--) {
+		data[idx] = (data[idx] << bits) | (data[idx - 1] >> (32 - bits));
+	}
+	data[0] <<= bits;
+	return out;
+}
+
+/*
+ * Schoolbook long division (Knuth's algorithm D). quot[0..numLen-divLen] gets
+ * num / div and num[0..divLen) is left holding the remainder. num needs room
+ * for numLen + 1 limbs, div is normalized in place and put back afterwards.
+ * div[divLen - 1] must be non-zero and numLen >= divLen.
+ */
+constexpr void limb_divmod_n(std::uint32_t* quot, std::uint32_t* num, std::size_t numLen, std::uint32_t* div, std::size_t divLen) {
+	if(divLen == 1) {
+		std::copy_n(num, numLen, quot);
+		num[0] = limb_divmod_1(quot, numLen, div[0]);
+		return;
+	}
+	// Shift so the top bit of div is set, that keeps every trial quotient within 2 of the real one
+	std::uint32_t shift = std::countl_zero(div[divLen - 1]);
+	limb_lshift(div, divLen, shift);
+	num[numLen] = limb_lshift(num, numLen, shift);
+	std::uint64_t top = div[divLen - 1];
+	std::uint64_t next = div[divLen - 2];
+	for(std::size_t idx = numLen - divLen + 1; idx > 0; idx--) {
+		std::size_t pos = idx - 1;
+		std::uint64_t head = ((std::uint64_t)num[pos + divLen] << 32) | num[pos + divLen - 1];
+		std::uint64_t qhat = head / top;
+		std::uint64_t rhat = head % top;
+		while((qhat > UINT32_MAX) || ((qhat * next) > ((rhat << 32) | num[pos + divLen - 2]))) {
+			qhat--;
+			rhat += top;
+			if(rhat > UINT32_MAX) break;
+		}
+		auto borrow = limb_submul_1(num + pos, div, divLen, qhat & 0xFFFFFFFF);
+		std::uint64_t diff = (std::uint64_t)num[pos + divLen] - borrow;
+		num[pos + divLen] = diff & 0xFFFFFFFF;
+		// Went one too far, add div back
+		if((diff >> 63) != 0) {
+			qhat--;
+			num[pos + divLen] += limb_add_n(num + pos, num + pos, div, divLen);
+		}
+		quot[pos] = qhat & 0xFFFFFFFF;
+	}
+	limb_rshift(num, divLen, shift);
+	limb_rshift(div, divLen, shift);
+}
+
+/*
+ * out[idx] = num mod moduli[idx] for count non-zero 32 bit moduli, reading num's
+ * limbs once from the top. The remainders for a block of moduli are kept in
+ * doubles: num is fed in 16 bits at a time so every intermediate stays below
+ * 2^49 and is exact, and the quotient estimate from the reciprocal is off by
+ * at most one. That leaves no divisions or branches in the inner loop, which
+ * runs four moduli per register with AVX.
+ */
+inline void limb_mod_u32_many(std::uint32_t const* num, std::size_t len, std::uint32_t const* moduli, std::uint32_t* out, std::size_t count) {
+	constexpr std::size_t lanes = 64;
+	alignas(32) double rem[lanes];
+	alignas(32) double mod[lanes];
+	alignas(32) double inv[lanes];
+	for(std::size_t base = 0; base < count; base += lanes) {
+		// Spare lanes in the last block just work modulo 1
+		std::size_t width = std::min(lanes, count - base);
+		for(std::size_t lane = 0; lane < lanes; lane++) {
+			rem[lane] = 0;
+			mod[lane] = (lane < width) ? moduli[base + lane] : 1;
+			inv[lane] = 1.0 / mod[lane];
+		}
+		for(std::size_t idx = len * 2; idx > 0; idx--) {
+			double half = (num[(idx - 1) / 2] >> (16 * ((idx - 1) % 2))) & 0xFFFF;
+#ifdef LIMB_KERNELS_AVX
+			__m256d shift = _mm256_set1_pd(65536.0);
+			__m256d feed = _mm256_set1_pd(half);
+			__m256d zero = _mm256_setzero_pd();
+			for(std::size_t lane = 0; lane < lanes; lane += 4) {
+				__m256d m = _mm256_load_pd(mod + lane);
+				__m256d value = _mm256_add_pd(_mm256_mul_pd(_mm256_load_pd(rem + lane), shift), feed);
+				__m256d quot = _mm256_floor_pd(_mm256_mul_pd(value, _mm256_load_pd(inv + lane)));
+				__m256d r = _mm256_sub_pd(value, _mm256_mul_pd(quot, m));
+				r = _mm256_add_pd(r, _mm256_and_pd(_mm256_cmp_pd(r, zero, _CMP_LT_OQ), m));
+				r = _mm256_sub_pd(r, _mm256_and_pd(_mm256_cmp_pd(r, m, _CMP_GE_OQ), m));
+				_mm256_store_pd(rem + lane, r);
+			}
+#else
+			for(std::size_t lane = 0; lane < lanes; lane++) {
+				double value = (rem[lane] * 65536.0) + half;
+				double r = value - (std::floor(value * inv[lane]) * mod[lane]);
+				r += (r < 0) ? mod[lane] : 0.0;
+				r -= (r >= mod[lane]) ? mod[lane] : 0.0;
+				rem[lane] = r;
+			}
+#endif
+		}
+		for(std::size_t lane = 0; lane < width; lane++) {
+			out[base + lane] = (std::uint32_t)rem[lane];
+		}
+	}
+}
+
+/*
+ * Carry-less kernels, the limbs are read as the coefficients of a binary
+ * polynomial (bit i of the array is the coefficient of x^i) and XOR takes
+ * the place of addition, so nothing ever carries between limbs.
+ */
+
+// Carry-less 32x32 bit product
+constexpr std::uint64_t limb_clmul_1(std::uint32_t lhs, std::uint32_t rhs) {
+	std::uint64_t res = 0;
+	for(std::size_t bit = 0; bit < 32; bit++) {
+		res ^= ((std::uint64_t)lhs << bit) & (0 - (std::uint64_t)((rhs >> bit) & 1));
+	}
+	return res;
+}
+
+// res[0..n) ^= data[0..n)
+constexpr void limb_xor_n(std::uint32_t* res, std::uint32_t const* data, std::size_t n) {
+	for(std::size_t idx = 0; idx < n; idx++) {
+		res[idx] ^= data[idx];
+	}
+}
+
+#ifdef LIMB_KERNELS_CLMUL
+// Carry-less product on 64 bit words, lengths are still in limbs and an odd
+// top limb on either side reads as a word with a zero high half
+inline void word_clmul_basecase(std::uint32_t* res, std::uint32_t const* lhs, std::size_t lhsLen, std::uint32_t const* rhs, std::size_t rhsLen) {
+	auto load = [](std::uint32_t const* data, std::size_t len, std::size_t word) -> __m128i {
+		std::uint64_t val = data[2 * word];
+		if(((2 * word) + 1) < len) {
+			val |= (std::uint64_t)data[(2 * word) + 1] << 32;
+		}
+		return _mm_cvtsi64_si128((long long)val);
+	};
+	std::size_t total = lhsLen + rhsLen;
+	std::size_t lhsWords = (lhsLen + 1) / 2;
+	std::size_t rhsWords = (rhsLen + 1) / 2;
+	for(std::size_t row = 0; row < rhsWords; row++) {
+		__m128i mult = load(rhs, rhsLen, row);
+		for(std::size_t col = 0; col < lhsWords; col++) {
+			__m128i prod = _mm_clmulepi64_si128(load(lhs, lhsLen, col), mult, 0x00);
+			std::uint64_t low = (std::uint64_t)_mm_cvtsi128_si64(prod);
+			std::uint64_t high = (std::uint64_t)_mm_extract_epi64(prod, 1);
+			// The top two limbs are only past the end when both sides are padded, they are zero then
+			std::size_t at = 2 * (row + col);
+			res[at] ^= (std::uint32_t)low;
+			res[at + 1] ^= (std::uint32_t)(low >> 32);
+			if((at + 2) < total) res[at + 2] ^= (std::uint32_t)high;
+			if((at + 3) < total) res[at + 3] ^= (std::uint32_t)(high >> 32);
+		}
+	}
+}
+#endif // LIMB_KERNELS_CLMUL
+
+// res[0..lhsLen+rhsLen) = lhs * rhs over GF(2), res must not alias either input
+constexpr void limb_clmul_basecase(std::uint32_t* res, std::uint32_t const* lhs, std::size_t lhsLen, std::uint32_t const* rhs, std::size_t rhsLen) {
+	for(std::size_t idx = 0; idx < lhsLen + rhsLen; idx++) {
+		res[idx] = 0;
+	}
+#ifdef LIMB_KERNELS_CLMUL
+	if(!std::is_constant_evaluated()) {
+		word_clmul_basecase(res, lhs, lhsLen, rhs, rhsLen);
+		return;
+	}
+#endif
+	for(std::size_t row = 0; row < rhsLen; row++) {
+		for(std::size_t col = 0; col < lhsLen; col++) {
+			auto prod = limb_clmul_1(lhs[col], rhs[row]);
+			res[row + col] ^= (std::uint32_t)prod;
+			res[row + col + 1] ^= (std::uint32_t)(prod >> 32);
+		}
+	}
+}
+
+// Below this many limbs the carry-less Karatsuba split costs more than it saves
+inline constexpr std::size_t limb_clmul_karatsuba_limbs = 16;
+
+// Scratch limbs limb_clmul_n needs for an n limb product
+constexpr std::size_t limb_clmul_scratch(std::size_t n) {
+	return (4 * n) + 64;
+}
+
+/*
+ * res[0..2n) = lhs * rhs over GF(2) for two n limb polynomials by Karatsuba.
+ * Without carries the middle term is just (l0 + l1)(r0 + r1) + l0 r0 + l1 r1
+ * with every + an XOR, so the split needs no sign handling or extra limbs.
+ * scratch needs limb_clmul_scratch(n) limbs.
+ */
+constexpr void limb_clmul_n(std::uint32_t* res, std::uint32_t const* lhs, std::uint32_t const* rhs, std::size_t n, std::uint32_t* scratch) {
+	if(n < limb_clmul_karatsuba_limbs) {
+		limb_clmul_basecase(res, lhs, n, rhs, n);
+		return;
+	}
+	// Low halves have low limbs, high halves the remaining high >= low limbs
+	std::size_t low = n / 2;
+	std::size_t high = n - low;
+	limb_clmul_n(res, lhs, rhs, low, scratch);
+	limb_clmul_n(res + (2 * low), lhs + low, rhs + low, high, scratch);
+
+	std::uint32_t* lhsSum = scratch;
+	std::uint32_t* rhsSum = scratch + high;
+	std::uint32_t* middle = scratch + (2 * high);
+	std::copy(lhs + low, lhs + n, lhsSum);
+	std::copy(rhs + low, rhs + n, rhsSum);
+	limb_xor_n(lhsSum, lhs, low);
+	limb_xor_n(rhsSum, rhs, low);
+	limb_clmul_n(middle, lhsSum, rhsSum, high, scratch + (4 * high));
+	limb_xor_n(middle, res, 2 * low);
+	limb_xor_n(middle, res + (2 * low), 2 * high);
+	limb_xor_n(res + low, middle, 2 * high);
+}
+
+// Spreads the 16 bits of val out to the even bits of the result
+constexpr std::uint32_t limb_clspread_16(std::uint32_t val) {
+	val = (val | (val << 8)) & 0x00FF00FF;
+	val = (val | (val << 4)) & 0x0F0F0F0F;
+	val = (val | (val << 2)) & 0x33333333;
+	val = (val | (val << 1)) & 0x55555555;
+	return val;
+}
+
+// res[0..2n) = data^2 over GF(2). Squaring is linear over GF(2), every cross
+// term appears twice and cancels, so this only interleaves zero bits
+constexpr void limb_clsquare(std::uint32_t* res, std::uint32_t const* data, std::size_t n) {
+	for(std::size_t idx = n; idx > 0; idx--) {
+		auto limb = data[idx - 1];
+		res[(2 * idx) - 1] = limb_clspread_16(limb >> 16);
+		res[(2 * idx) - 2] = limb_clspread_16(limb & 0xFFFF);
+	}
+}
+
+/*
+ * data mod f over GF(2) in place, with f = x^degree + x^taps[0] + ... the
+ * sparse polynomial and every tap below degree (x^0 for the constant term
+ * is a tap like the rest). Since x^degree = sum x^tap, the bits above degree
+ * are folded back down from the top one chunk at a time, each chunk is
+ * XORed back in once per tap. Chunks are at most degree - max(taps) bits so
+ * nothing a fold writes lands on a chunk still to be folded.
+ */
+constexpr void limb_clreduce_sparse(std::uint32_t* data, std::size_t len, std::size_t degree, std::size_t const* taps, std::size_t tapCount) {
+	auto extract = [&](std::size_t pos, std::size_t width) -> std::uint64_t {
+		std::size_t word = pos >> 5;
+		std::uint64_t buff = data[word];
+		if((word + 1) < len) {
+			buff |= (std::uint64_t)data[word + 1] << 32;
+		}
+		return (buff >> (pos & 0x1F)) & (((std::uint64_t)1 << width) - 1);
+	};
+	auto flip = [&](std::size_t pos, std::uint64_t val) {
+		std::size_t word = pos >> 5;
+		val <<= (pos & 0x1F);
+		data[word] ^= (std::uint32_t)val;
+		if(((word + 1) < len) && ((val >> 32) != 0)) {
+			data[word + 1] ^= (std::uint32_t)(val >> 32);
+		}
+	};
+	std::size_t maxTap = 0;
+	for(std::size_t idx = 0; idx < tapCount; idx++) {
+		maxTap = std::max(maxTap, taps[idx]);
+	}
+	std::size_t step = std::min<std::size_t>(32, degree - maxTap);
+	std::size_t end = limb_active_length(data, len) * 32;
+	while(end > degree) {
+		std::size_t pos = std::max(degree, end - std::min(step, end));
+		std::uint64_t chunk = extract(pos, end - pos);
+		if(chunk != 0) {
+			flip(pos, chunk);
+			for(std::size_t idx = 0; idx < tapCount; idx++) {
+				flip((pos - degree) + taps[idx], chunk);
+			}
+		}
+		end = pos;
+	}
+}
+
+#endif // LIMB_KERNELS_H_7D2C9A41E0B34F6B8E51C3A9F04D2B17
@@ -0,0 +1,200 @@
+/*
+ * File:      persistent_bignum.h
+ * Author:    Daniel Hannon
+ *
+ * Copyright: 2024 Daniel Hannon
+ *
+ * Brief: Named ArbitraryBigNum values that outlive the process.
+ */
+
+#ifndef PERSISTENT_BIGNUM_H_865BF50C12164F7B98AB49F53798C60B
+#define PERSISTENT_BIGNUM_H_865BF50C12164F7B98AB49F53798C60B 1
+
+#include "arbitrary_bignum.h"
+#include "cold_vector.h"
+#include "util.h"
+
+#include <array>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * PersistentBigNum is an ArbitraryBigNum in cold storage with a name that
+ * can be opened again after the process is gone. checkpoint() writes the
+ * file called name: a header of five 64 bit words (magic, base, sign, digit
+ * count and a Fletcher-64 checksum of the digits) and then the digits
+ * exactly as ColdVector stores them. The new file is synced under a
+ * temporary name and renamed over the old one, so a crash at any point
+ * leaves either the previous checkpoint or the new one.
+ *
+ * open() only reads the header and the top digit. The value borrows its
+ * digits straight out of the checkpoint file and copies them to a file of
+ * its own on the first write, so the checkpoint stays untouched until the
+ * next one replaces it. open() does not check the checksum, a checkpoint
+ * that may have been damaged should go through verify() first.
+ */
+template<std::size_t MAX_VAL = UINT32_MAX>
+struct PersistentBigNum {
+	using Number = ArbitraryBigNum<MAX_VAL, ColdLimbs>;
+	using Header = std::array<std::uint64_t, 5>; // Magic, base, sign, digit count and checksum
+
+	// A new persistent number, nothing reaches the file until checkpoint()
+	PersistentBigNum(std::string name, Number value = Number{0}) : m_name{std::move(name)}, m_value{std::move(value)}
+	{}
+
+	// The last checkpoint of name. Throws std::runtime_error when it is missing,
+	// cut short, written in another base or its top digit is zero. The checksum
+	// is not checked, that is what verify() is for
+	static PersistentBigNum open(std::string const& name) {
+		auto header = read_header(name);
+		std::error_code error;
+		auto fileSize = std::filesystem::file_size(name, error);
+		if(error || (fileSize < (sizeof(header) + (header[sc_countWord] * sizeof(std::uint32_t))))) {
+			throw std::runtime_error("Checkpoint " + name + " is cut short");
+		}
+		Number value{0U};
+		value.m_data = ColdLimbs{name, sizeof(header), header[sc_countWord]};
+		value.m_signed = (header[sc_signWord] != 0);
+		// Zero is a single zero digit, anything else has a non-zero top digit
+		ColdLimbs const& digits = value.m_data;
+		std::uint32_t top = digits[digits.size() - 1];
+		if((top == 0) && ((digits.size() > 1) || value.m_signed)) {
+			throw std::runtime_error("Checkpoint " + name + " is damaged");
+		}
+		return PersistentBigNum{name, std::move(value)};
+	}
+
+	// Reads every digit of the checkpoint of name back and checks it against the checksum
+	static bool verify(std::string const& name) {
+		Header header;
+		try {
+			header = read_header(name);
+		} catch(std::runtime_error const&) {
+			return false;
+		}
+		std::ifstream file{name, std::ios::in | std::ios::binary};
+		file.seekg(sizeof(header), std::ios::beg);
+		Checksum sum;
+		std::vector<std::uint32_t> block(sc_blockDigits);
+		for(std::size_t left = header[sc_countWord]; left != 0;) {
+			std::size_t len = std::min(left, block.size());
+			if(!file.read(reinterpret_cast<char*>(block.data()), len * sizeof(std::uint32_t))) {
+				return false;
+			}
+			sum.add(block.data(), len);
+			left -= len;
+		}
+		return sum.value() == header[sc_checksumWord];
+	}
+
+	Number& value() noexcept {
+		return m_value;
+	}
+
+	Number const& value() const noexcept {
+		return m_value;
+	}
+
+	std::string const& name() const noexcept {
+		return m_name;
+	}
+
+	// Durably replaces the checkpoint of name with the current value. Returns
+	// false, leaving the previous checkpoint in place, if it can't be written
+	bool checkpoint() const {
+		std::string temp = m_name + ".tmp";
+		auto const& digits = m_value.m_data;
+		{
+			std::ofstream file{temp, std::ios::out | std::ios::binary | std::ios::trunc};
+			if(!file.is_open()) return false;
+			Header header{sc_magic, sc_base, m_value.m_signed, digits.size(), 0};
+			file.write(reinterpret_cast<char const*>(header.data()), sizeof(header));
+
+			// The digits go out in large blocks, the checksum is worked out on the way
+			Checksum sum;
+			std::vector<std::uint32_t> block(sc_blockDigits);
+			for(std::size_t start = 0; start < digits.size(); start += block.size()) {
+				std::size_t len = std::min(block.size(), digits.size() - start);
+				for(std::size_t idx = 0; idx < len; idx++) {
+					block[idx] = digits[start + idx];
+				}
+				sum.add(block.data(), len);
+				file.write(reinterpret_cast<char const*>(block.data()), len * sizeof(std::uint32_t));
+			}
+			header[sc_checksumWord] = sum.value();
+			file.seekp(0, std::ios::beg);
+			file.write(reinterpret_cast<char const*>(header.data()), sizeof(header));
+			if(!file.flush()) {
+				file.close();
+				std::remove(temp.c_str());
+				return false;
+			}
+		}
+		if(!sync_path(temp) || (std::rename(temp.c_str(), m_name.c_str()) != 0)) {
+			std::remove(temp.c_str());
+			return false;
+		}
+		// The rename itself only lasts once the directory is synced
+		auto directory = std::filesystem::path{m_name}.parent_path();
+		return sync_path(directory.empty() ? std::string{"."} : directory.string());
+	}
+
+private:
+	// Fletcher-64 over 32 bit digits
+	struct Checksum {
+		void add(std::uint32_t const* data, std::size_t len) {
+			for(std::size_t idx = 0; idx < len; idx++) {
+				m_low = (m_low + data[idx]) % UINT32_MAX;
+				m_high = (m_high + m_low) % UINT32_MAX;
+			}
+		}
+
+		std::uint64_t value() const {
+			return (m_high << 32) | m_low;
+		}
+
+		std::uint64_t m_low = 0;
+		std::uint64_t m_high = 0;
+	};
+
+	static Header read_header(std::string const& name) {
+		Header header;
+		std::ifstream file{name, std::ios::in | std::ios::binary};
+		if(!file.is_open()) {
+			throw std::runtime_error("Cannot open checkpoint " + name);
+		}
+		if(!file.read(reinterpret_cast<char*>(header.data()), sizeof(header)) || (header[sc_magicWord] != sc_magic)) {
+			throw std::runtime_error(name + " is not a checkpoint");
+		}
+		if(header[sc_baseWord] != sc_base) {
+			throw std::runtime_error("Checkpoint " + name + " was written in another base");
+		}
+		if(header[sc_countWord] == 0) {
+			throw std::runtime_error("Checkpoint " + name + " has no digits");
+		}
+		return header;
+	}
+
+private:
+	static constexpr std::size_t	sc_magicWord = 0;						  // Header word holding sc_magic
+	static constexpr std::size_t	sc_baseWord = 1;						  // Header word holding the base
+	static constexpr std::size_t	sc_signWord = 2;						  // Header word holding the sign
+	static constexpr std::size_t	sc_countWord = 3;						  // Header word holding the digit count
+	static constexpr std::size_t	sc_checksumWord = 4;					  // Header word holding the checksum
+	static constexpr std::uint64_t	sc_magic = 0x314D554E47494241;			  // "ABIGNUM1"
+	static constexpr std::uint64_t	sc_base = (std::uint64_t)MAX_VAL + 1;	  // Base the digits are in
+	static constexpr std::size_t	sc_blockDigits = std::size_t{1} << 16;	  // Digits read or written at a time
+	std::string						m_name;									  // File the checkpoints go to
+	Number							m_value;								  // The live value
+};
+
+#endif // PERSISTENT_BIGNUM_H_865BF50C12164F7B98AB49F53798C60B
@@ -0,0 +1,138 @@
+/*
+ * File:      remainder_tree.h
+ * Author:    Daniel Hannon
+ *
+ * Copyright: 2024 Daniel Hannon
+ */
+
+#ifndef REMAINDER_TREE_H_8B3E6F1A0C9D4B25A7E2D5C8F16B3A94
+#define REMAINDER_TREE_H_8B3E6F1A0C9D4B25A7E2D5C8F16B3A94 1
+
+#include "fixed_bignum.h"
+#include "limb_kernels.h"
+
+#include <algorithm>
+#include <span>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+// num mod moduli[idx] for every modulus, these are remainders of the magnitude
+template<std::size_t U>
+std::vector<std::uint32_t> mod_u32_many(FixedBigNum<U> const& num, std::span<std::uint32_t const> moduli) {
+	std::vector<std::uint32_t> result(moduli.size());
+	auto limbs = num.limbs();
+	limb_mod_u32_many(limbs.data(), limbs.size(), moduli.data(), result.data(), moduli.size());
+	return result;
+}
+
+/*
+ * Product tree over a list of non-zero 32 bit moduli. The leaves hold the
+ * products of sc_leafSize neighbouring moduli and every node above holds the
+ * product of its two children. reduce() walks a number down the tree, taking
+ * it modulo each node in turn, so the numbers shrink towards the leaves and
+ * only the short leaf remainders get the per-modulus pass. product() doubles
+ * as the modulus for CRT reconstruction.
+ */
+struct RemainderTree {
+	explicit RemainderTree(std::span<std::uint32_t const> moduli) : m_moduli{moduli.begin(), moduli.end()}, m_levels{}
+	{
+		std::vector<std::vector<std::uint32_t>> leaves;
+		for(std::size_t base = 0; base < m_moduli.size(); base += sc_leafSize) {
+			std::vector<std::uint32_t> product{1};
+			for(std::size_t idx = base; idx < std::min(base + sc_leafSize, m_moduli.size()); idx++) {
+				auto carry = limb_mul_1_add(product.data(), product.size(), m_moduli[idx], 0);
+				if(carry != 0) {
+					product.push_back(carry);
+				}
+			}
+			leaves.push_back(std::move(product));
+		}
+		if(leaves.empty()) {
+			leaves.push_back({1});
+		}
+		m_levels.push_back(std::move(leaves));
+
+		while(m_levels.back().size() > 1) {
+			auto const& below = m_levels.back();
+			std::vector<std::vector<std::uint32_t>> level;
+			for(std::size_t idx = 0; idx < below.size(); idx += 2) {
+				if((idx + 1) == below.size()) {
+					level.push_back(below[idx]);
+					continue;
+				}
+				auto const& lhs = below[idx];
+				auto const& rhs = below[idx + 1];
+				std::vector<std::uint32_t> product(lhs.size() + rhs.size());
+				limb_mul_basecase(product.data(), lhs.data(), lhs.size(), rhs.data(), rhs.size());
+				product.resize(std::max<std::size_t>(limb_active_length(product.data(), product.size()), 1));
+				level.push_back(std::move(product));
+			}
+			m_levels.push_back(std::move(level));
+		}
+	}
+
+	std::size_t size() const {
+		return m_moduli.size();
+	}
+
+	// Product of every modulus, least significant limb first
+	std::vector<std::uint32_t> const& product() const {
+		return m_levels.back()[0];
+	}
+
+	// out[idx] = num mod moduli[idx] for the len limbs at num
+	void reduce(std::uint32_t const* num, std::size_t len, std::uint32_t* out) const {
+		std::vector<std::vector<std::uint32_t>> rems{std::vector<std::uint32_t>(num, num + len)};
+		for(std::size_t level = m_levels.size(); level > 0; level--) {
+			auto const& nodes = m_levels[level - 1];
+			std::vector<std::vector<std::uint32_t>> next;
+			for(std::size_t idx = 0; idx < nodes.size(); idx++) {
+				// The top level has a single node fed straight from num
+				auto const& parent = rems[(level == m_levels.size()) ? 0 : idx / 2];
+				next.push_back(remainder(parent, nodes[idx]));
+			}
+			rems = std::move(next);
+		}
+		for(std::size_t leaf = 0; leaf < rems.size(); leaf++) {
+			std::size_t base = leaf * sc_leafSize;
+			std::size_t count = std::min(sc_leafSize, m_moduli.size() - base);
+			limb_mod_u32_many(rems[leaf].data(), rems[leaf].size(), m_moduli.data() + base, out + base, count);
+		}
+	}
+
+	// Remainders of the magnitude of num, one per modulus
+	template<std::size_t U>
+	std::vector<std::uint32_t> reduce(FixedBigNum<U> const& num) const {
+		std::vector<std::uint32_t> result(m_moduli.size());
+		auto limbs = num.limbs();
+		reduce(limbs.data(), limbs.size(), result.data());
+		return result;
+	}
+
+private:
+	// num mod div, num is already below the parent node so this is one long division at most
+	static std::vector<std::uint32_t> remainder(std::vector<std::uint32_t> const& num, std::vector<std::uint32_t> const& div) {
+		std::size_t numLen = limb_active_length(num.data(), num.size());
+		std::vector<std::uint32_t> rem(num.begin(), num.begin() + numLen);
+		if(numLen < div.size()) {
+			return rem;
+		}
+		rem.push_back(0);
+		std::vector<std::uint32_t> divisor{div};
+		std::vector<std::uint32_t> quot(numLen - div.size() + 1);
+		limb_divmod_n(quot.data(), rem.data(), numLen, divisor.data(), divisor.size());
+		rem.resize(div.size());
+		return rem;
+	}
+
+private:
+	// Moduli per leaf, the leaf products are then 64 limbs at most
+	static constexpr std::size_t sc_leafSize = 64;
+
+	std::vector<std::uint32_t>						m_moduli; // The moduli in the order they were given
+	std::vector<std::vector<std::vector<std::uint32_t>>> m_levels; // m_levels[0] are the leaves, back() the root
+};
+
+#endif // REMAINDER_TREE_H_8B3E6F1A0C9D4B25A7E2D5C8F16B3A94
@@ -0,0 +1,447 @@
+/*
+ * File:      rns.h
+ * Author:    Daniel Hannon
+ *
+ * Copyright: 2024 Daniel Hannon
+ */
+
+#ifndef RNS_H_61C8E3B5A2F04D9B8E7A3C1D6F2B9E47
+#define RNS_H_61C8E3B5A2F04D9B8E7A3C1D6F2B9E47 1
+
+#include "fixed_base_pow.h"
+#include "fixed_bignum.h"
+#include "limb_kernels.h"
+
+#include <algorithm>
+#include <array>
+#include <compare>
+#include <span>
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) && defined(__AVX2__)
+#include <immintrin.h>
+#define RNS_LANES_AVX2 1
+#endif
+
+/*
+ * Lane kernels, every lane has its own prime p < 2^31. Residues are always
+ * kept in [0, p), so a sum still fits in 32 bits and a single conditional
+ * subtraction (done as an unsigned min) puts it back in range. With AVX2
+ * eight lanes go through at once.
+ */
+
+// a * b * 2^-32 mod p for a, b < p, pinv is -p^-1 mod 2^32
+constexpr std::uint32_t rns_mont_mul_1(std::uint32_t a, std::uint32_t b, std::uint32_t p, std::uint32_t pinv) {
+	std::uint64_t product = (std::uint64_t)a * b;
+	std::uint32_t m = (std::uint32_t)product * pinv;
+	std::uint64_t sum = (product + ((std::uint64_t)m * p)) >> 32;
+	return (sum >= p) ? (sum - p) : sum;
+}
+
+#ifdef RNS_LANES_AVX2
+// Eight lanes of rns_mont_mul_1, mul_epu32 only uses the even lanes so the odd ones go through shifted down
+inline __m256i rns_mont_mul_8(__m256i a, __m256i b, __m256i p, __m256i pinv) {
+	__m256i productEven = _mm256_mul_epu32(a, b);
+	__m256i productOdd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32));
+	__m256i mEven = _mm256_mul_epu32(productEven, pinv);
+	__m256i mOdd = _mm256_mul_epu32(productOdd, _mm256_srli_epi64(pinv, 32));
+	__m256i sumEven = _mm256_add_epi64(productEven, _mm256_mul_epu32(mEven, p));
+	__m256i sumOdd = _mm256_add_epi64(productOdd, _mm256_mul_epu32(mOdd, _mm256_srli_epi64(p, 32)));
+	// The results are the high halves, the odd ones are already in place
+	__m256i sum = _mm256_blend_epi32(_mm256_srli_epi64(sumEven, 32), sumOdd, 0xAA);
+	return _mm256_min_epu32(sum, _mm256_sub_epi32(sum, p));
+}
+#endif
+
+// res = (a + b) mod p over n lanes
+inline void rns_add(std::uint32_t* res, std::uint32_t const* a, std::uint32_t const* b, std::uint32_t const* p, std::size_t n) {
+	std::size_t idx = 0;
+#ifdef RNS_LANES_AVX2
+	for(; (idx + 8) <= n; idx += 8) {
+		__m256i mod = _mm256_loadu_si256((__m256i const*)(p + idx));
+		__m256i sum = _mm256_add_epi32(_mm256_loadu_si256((__m256i const*)(a + idx)), _mm256_loadu_si256((__m256i const*)(b + idx)));
+		_mm256_storeu_si256((__m256i*)(res + idx), _mm256_min_epu32(sum, _mm256_sub_epi32(sum, mod)));
+	}
+#endif
+	for(; idx < n; idx++) {
+		std::uint32_t sum = a[idx] + b[idx];
+		res[idx] = std::min(sum, sum - p[idx]);
+	}
+}
+
+// res = (a - b) mod p over n lanes
+inline void rns_sub(std::uint32_t* res, std::uint32_t const* a, std::uint32_t const* b, std::uint32_t const* p, std::size_t n) {
+	std::size_t idx = 0;
+#ifdef RNS_LANES_AVX2
+	for(; (idx + 8) <= n; idx += 8) {
+		__m256i mod = _mm256_loadu_si256((__m256i const*)(p + idx));
+		__m256i diff = _mm256_sub_epi32(_mm256_loadu_si256((__m256i const*)(a + idx)), _mm256_loadu_si256((__m256i const*)(b + idx)));
+		_mm256_storeu_si256((__m256i*)(res + idx), _mm256_min_epu32(diff, _mm256_add_epi32(diff, mod)));
+	}
+#endif
+	for(; idx < n; idx++) {
+		std::uint32_t diff = a[idx] - b[idx];
+		res[idx] = std::min(diff, diff + p[idx]);
+	}
+}
+
+// res = a * b * 2^-32 mod p over n lanes
+inline void rns_mont_mul(std::uint32_t* res, std::uint32_t const* a, std::uint32_t const* b, std::uint32_t const* p, std::uint32_t const* pinv, std::size_t n) {
+	std::size_t idx = 0;
+#ifdef RNS_LANES_AVX2
+	for(; (idx + 8) <= n; idx += 8) {
+		__m256i product = rns_mont_mul_8(_mm256_loadu_si256((__m256i const*)(a + idx)), _mm256_loadu_si256((__m256i const*)(b + idx)),
+										 _mm256_loadu_si256((__m256i const*)(p + idx)), _mm256_loadu_si256((__m256i const*)(pinv + idx)));
+		_mm256_storeu_si256((__m256i*)(res + idx), product);
+	}
+#endif
+	for(; idx < n; idx++) {
+		res[idx] = rns_mont_mul_1(a[idx], b[idx], p[idx], pinv[idx]);
+	}
+}
+
+// res = (a - digit) mod p over n lanes, digit is a residue from some other lane so it only needs one reduction
+inline void rns_sub_digit(std::uint32_t* res, std::uint32_t const* a, std::uint32_t digit, std::uint32_t const* p, std::size_t n) {
+	std::size_t idx = 0;
+#ifdef RNS_LANES_AVX2
+	__m256i wide = _mm256_set1_epi32(digit);
+	for(; (idx + 8) <= n; idx += 8) {
+		__m256i mod = _mm256_loadu_si256((__m256i const*)(p + idx));
+		__m256i reduced = _mm256_min_epu32(wide, _mm256_sub_epi32(wide, mod));
+		__m256i diff = _mm256_sub_epi32(_mm256_loadu_si256((__m256i const*)(a + idx)), reduced);
+		_mm256_storeu_si256((__m256i*)(res + idx), _mm256_min_epu32(diff, _mm256_add_epi32(diff, mod)));
+	}
+#endif
+	for(; idx < n; idx++) {
+		std::uint32_t reduced = std::min(digit, digit - p[idx]);
+		std::uint32_t diff = a[idx] - reduced;
+		res[idx] = std::min(diff, diff + p[idx]);
+	}
+}
+
+// acc = (acc * b * 2^-32 + digit) mod p over n lanes, one Horner step of a base extension
+inline void rns_mont_mul_digit(std::uint32_t* acc, std::uint32_t const* b, std::uint32_t digit, std::uint32_t const* p, std::uint32_t const* pinv, std::size_t n) {
+	std::size_t idx = 0;
+#ifdef RNS_LANES_AVX2
+	__m256i wide = _mm256_set1_epi32(digit);
+	for(; (idx + 8) <= n; idx += 8) {
+		__m256i mod = _mm256_loadu_si256((__m256i const*)(p + idx));
+		__m256i product = rns_mont_mul_8(_mm256_loadu_si256((__m256i const*)(acc + idx)), _mm256_loadu_si256((__m256i const*)(b + idx)),
+										 mod, _mm256_loadu_si256((__m256i const*)(pinv + idx)));
+		__m256i sum = _mm256_add_epi32(product, _mm256_min_epu32(wide, _mm256_sub_epi32(wide, mod)));
+		_mm256_storeu_si256((__m256i*)(acc + idx), _mm256_min_epu32(sum, _mm256_sub_epi32(sum, mod)));
+	}
+#endif
+	for(; idx < n; idx++) {
+		std::uint32_t sum = rns_mont_mul_1(acc[idx], b[idx], p[idx], pinv[idx]) + std::min(digit, digit - p[idx]);
+		acc[idx] = std::min(sum, sum - p[idx]);
+	}
+}
+
+// base^exp mod p with 64 bit intermediates
+constexpr std::uint32_t rns_pow_1(std::uint64_t base, std::uint64_t exp, std::uint32_t p) {
+	std::uint64_t result = 1 % p;
+	base %= p;
+	for(; exp != 0; exp >>= 1) {
+		if(exp & 1) {
+			result = (result * base) % p;
+		}
+		base = (base * base) % p;
+	}
+	return result;
+}
+
+/*
+ * The first K primes below 2^31 and the per-lane constants that go with
+ * them. Every prime is above 2^30, so a residue for one lane is below twice
+ * any other lane's prime. Constants ending up in Montgomery form (times
+ * 2^32) turn a multiplication by them into one rns_mont_mul.
+ */
+template<std::size_t K>
+struct RnsBasis {
+	static RnsBasis const& get() {
+		static RnsBasis const basis{};
+		return basis;
+	}
+
+	std::array<std::uint32_t, K>					   primes;	// p_i
+	std::array<std::uint32_t, K>					   pinv;	// -p_i^-1 mod 2^32
+	std::array<std::uint32_t, K>					   square;	// 2^64 mod p_i, undoes a Montgomery factor
+	std::array<std::array<std::uint32_t, K>, K> inverse; // inverse[j][i] = p_j^-1 * 2^32 mod p_i
+	std::array<std::array<std::uint32_t, K>, K> radix;	// radix[j][i] = p_j * 2^32 mod p_i
+
+	// value * 2^32 mod p_lane
+	std::uint32_t to_montgomery(std::uint64_t value, std::size_t lane) const {
+		return (((value % primes[lane]) << 32) % primes[lane]) & 0xFFFFFFFF;
+	}
+
+	// A residue from another lane (anything below 2^31) taken modulo p_lane
+	std::uint32_t take(std::uint32_t value, std::size_t lane) const {
+		return (value >= primes[lane]) ? (value - primes[lane]) : value;
+	}
+
+private:
+	RnsBasis() {
+		std::uint32_t candidate = 0x7FFFFFFF;
+		for(std::size_t idx = 0; idx < K; idx++, candidate -= 2) {
+			while(!is_prime(candidate)) {
+				candidate -= 2;
+			}
+			primes[idx] = candidate;
+			pinv[idx] = 0 - limb_binvert_1(candidate);
+			std::uint64_t r = ((std::uint64_t)1 << 32) % candidate;
+			square[idx] = (r * r) % candidate;
+		}
+		for(std::size_t j = 0; j < K; j++) {
+			for(std::size_t i = 0; i < K; i++) {
+				inverse[j][i] = (i == j) ? 0 : to_montgomery(rns_pow_1(primes[j], primes[i] - 2, primes[i]), i);
+				radix[j][i] = to_montgomery(primes[j], i);
+			}
+		}
+	}
+
+	// Miller-Rabin with bases 2, 3, 5 and 7 is exact below 3215031751
+	static bool is_prime(std::uint32_t n) {
+		std::uint32_t odd = n - 1;
+		std::size_t twos = 0;
+		for(; (odd & 1) == 0; odd >>= 1) {
+			twos++;
+		}
+		for(std::uint32_t witness : {2U, 3U, 5U, 7U}) {
+			std::uint64_t x = rns_pow_1(witness, odd, n);
+			if((x == 1) || (x == (n - 1))) continue;
+			bool composite = true;
+			for(std::size_t idx = 1; (idx < twos) && composite; idx++) {
+				x = (x * x) % n;
+				composite = (x != (n - 1));
+			}
+			if(composite) return false;
+		}
+		return true;
+	}
+};
+
+/*
+ * A number modulo M = p_0 * p_1 * ... * p_(N-1) stored as its N residues.
+ * Addition, subtraction and multiplication are independent per lane, there
+ * are no carries anywhere. Going back to a FixedBigNum uses Garner's mixed
+ * radix conversion, base_extend() uses the same digits to fill in lanes
+ * from a subset of the others.
+ */
+template<std::size_t N>
+struct RnsNum {
+	static_assert(N != 0, "You cant have a 0 lane number");
+
+	RnsNum() : m_res{}
+	{}
+
+	RnsNum(std::integral auto x) : RnsNum{FixedBigNum<2>{x}}
+	{}
+
+	// Negative values become M - |x|
+	template<std::size_t U>
+	explicit RnsNum(FixedBigNum<U> const& x) : m_res{}
+	{
+		auto const& basis = RnsBasis<N>::get();
+		auto limbs = x.limbs();
+		limb_mod_u32_many(limbs.data(), limbs.size(), basis.primes.data(), m_res.data(), N);
+		if(signbit(x)) {
+			std::array<std::uint32_t, N> zero{};
+			rns_sub(m_res.data(), zero.data(), m_res.data(), basis.primes.data(), N);
+		}
+	}
+
+	// The value in [0, M), truncated if M does not fit in U limbs
+	template<std::size_t U>
+	explicit operator FixedBigNum<U>() const {
+		auto const& basis = RnsBasis<N>::get();
+		auto digits = mixed_radix(0, N);
+		FixedBigNum<U> result{digits[N - 1]};
+		for(std::size_t idx = N - 1; idx > 0; idx--) {
+			result *= basis.primes[idx - 1];
+			result += digits[idx - 1];
+		}
+		return result;
+	}
+
+// Comparators, only equality makes sense without converting back
+	bool operator==(RnsNum const& cmp) const {
+		return m_res == cmp.m_res;
+	}
+
+// Arithmetic
+	RnsNum& operator+=(RnsNum const& add) {
+		rns_add(m_res.data(), m_res.data(), add.m_res.data(), RnsBasis<N>::get().primes.data(), N);
+		return *this;
+	}
+
+	RnsNum operator+(RnsNum const& add) const {
+		RnsNum temp{*this};
+		temp += add;
+		return temp;
+	}
+
+	RnsNum& operator-=(RnsNum const& sub) {
+		rns_sub(m_res.data(), m_res.data(), sub.m_res.data(), RnsBasis<N>::get().primes.data(), N);
+		return *this;
+	}
+
+	RnsNum operator-(RnsNum const& sub) const {
+		RnsNum temp{*this};
+		temp -= sub;
+		return temp;
+	}
+
+	// Two Montgomery products per lane, the second one cancels the 2^-32 of the first
+	RnsNum& operator*=(RnsNum const& mult) {
+		auto const& basis = RnsBasis<N>::get();
+		rns_mont_mul(m_res.data(), m_res.data(), mult.m_res.data(), basis.primes.data(), basis.pinv.data(), N);
+		rns_mont_mul(m_res.data(), m_res.data(), basis.square.data(), basis.primes.data(), basis.pinv.data(), N);
+		return *this;
+	}
+
+	RnsNum operator*(RnsNum const& mult) const {
+		RnsNum temp{*this};
+		temp *= mult;
+		return temp;
+	}
+
+	// Treats lanes [lo, hi) as the whole number (modulo the product of their primes)
+	// and recomputes every other lane from them
+	RnsNum& base_extend(std::size_t lo, std::size_t hi) {
+		auto const& basis = RnsBasis<N>::get();
+		auto digits = mixed_radix(lo, hi);
+		auto horner = [&](std::size_t begin, std::size_t end) {
+			if(begin == end) return;
+			for(std::size_t lane = begin; lane < end; lane++) {
+				m_res[lane] = basis.take(digits[hi - 1], lane);
+			}
+			for(std::size_t idx = hi - 1; idx > lo; idx--) {
+				rns_mont_mul_digit(m_res.data() + begin, basis.radix[idx - 1].data() + begin, digits[idx - 1], basis.primes.data() + begin, basis.pinv.data() + begin, end - begin);
+			}
+		};
+		horner(0, lo);
+		horner(hi, N);
+		return *this;
+	}
+
+	// The same number over a larger basis, the first N lanes carry over unchanged
+	template<std::size_t M>
+	RnsNum<M> extend() const {
+		static_assert(M >= N, "extend() only grows the basis");
+		RnsNum<M> result{};
+		std::copy(m_res.begin(), m_res.end(), result.m_res.begin());
+		result.base_extend(0, N);
+		return result;
+	}
+
+	std::span<std::uint32_t const> residues() const {
+		return {m_res.data(), N};
+	}
+
+private:
+	template<std::size_t>
+	friend struct RnsNum;
+
+	template<std::size_t, std::size_t>
+	friend struct RnsMontgomery;
+
+	// Garner's mixed radix digits of lanes [lo, hi): the value is d_lo + d_(lo+1) p_lo + ...
+	// Done a column at a time so each step runs across all the remaining lanes
+	std::array<std::uint32_t, N> mixed_radix(std::size_t lo, std::size_t hi) const {
+		auto const& basis = RnsBasis<N>::get();
+		std::array<std::uint32_t, N> digits{m_res};
+		for(std::size_t idx = lo; (idx + 1) < hi; idx++) {
+			std::size_t next = idx + 1;
+			rns_sub_digit(digits.data() + next, digits.data() + next, digits[idx], basis.primes.data() + next, hi - next);
+			rns_mont_mul(digits.data() + next, digits.data() + next, basis.inverse[idx].data() + next, basis.primes.data() + next, basis.pinv.data() + next, hi - next);
+		}
+		return digits;
+	}
+
+private:
+	std::array<std::uint32_t, N> m_res; // m_res[i] is the value mod p_i
+};
+
+/*
+ * Montgomery reduction modulo an odd P carried out entirely in RNS (Bajard et
+ * al). Numbers live on 2N lanes, the first N primes form the base B with
+ * product M and the next N form B'. reduce(x) gives x * M^-1 mod P, up to
+ * one extra P, using two exact base extensions instead of any carries.
+ *
+ * P needs to be below M / 4 so products of reduced values stay in range.
+ */
+template<std::size_t N, std::size_t U>
+struct RnsMontgomery {
+	using Num = RnsNum<2 * N>;
+
+	explicit RnsMontgomery(FixedBigNum<U> const& mod) : m_mod{mod}, m_negInverse{}, m_modulus{}, m_scale{}, m_square{}
+	{
+		auto const& basis = RnsBasis<2 * N>::get();
+		auto limbs = mod.limbs();
+		std::array<std::uint32_t, 2 * N> residues;
+		limb_mod_u32_many(limbs.data(), limbs.size(), basis.primes.data(), residues.data(), 2 * N);
+		FixedBigNum<U> baseMod{1};
+		for(std::size_t lane = 0; lane < N; lane++) {
+			baseMod = mul_mod(baseMod, FixedBigNum<U>{basis.primes[lane]}, mod);
+		}
+		for(std::size_t lane = 0; lane < 2 * N; lane++) {
+			std::uint32_t p = basis.primes[lane];
+			m_modulus[lane] = basis.to_montgomery(residues[lane], lane);
+			if(lane < N) {
+				m_negInverse[lane] = basis.to_montgomery(p - rns_pow_1(residues[lane], p - 2, p), lane);
+			} else {
+				std::uint64_t product = 1;
+				for(std::size_t idx = 0; idx < N; idx++) {
+					product = (product * basis.primes[idx]) % p;
+				}
+				m_scale[lane] = basis.to_montgomery(rns_pow_1(product, p - 2, p), lane);
+			}
+		}
+		m_square = Num{mul_mod(baseMod, baseMod, mod)};
+	}
+
+	// x * M^-1 mod P, the result is below 2P as long as x is below M * P
+	Num reduce(Num const& x) const {
+		auto const& basis = RnsBasis<2 * N>::get();
+		auto const* primes = basis.primes.data();
+		auto const* pinv = basis.pinv.data();
+		// q = -x / P mod M on B, then carried over to B'
+		Num q{x};
+		rns_mont_mul(q.m_res.data(), q.m_res.data(), m_negInverse.data(), primes, pinv, N);
+		q.base_extend(0, N);
+		// (x + q P) / M is exact, so it can be worked out on B' alone
+		Num result{};
+		rns_mont_mul(result.m_res.data() + N, q.m_res.data() + N, m_modulus.data() + N, primes + N, pinv + N, N);
+		rns_add(result.m_res.data() + N, result.m_res.data() + N, x.m_res.data() + N, primes + N, N);
+		rns_mont_mul(result.m_res.data() + N, result.m_res.data() + N, m_scale.data() + N, primes + N, pinv + N, N);
+		result.base_extend(N, 2 * N);
+		return result;
+	}
+
+	// Both sides in Montgomery form, so is the result
+	Num mul(Num const& lhs, Num const& rhs) const {
+		return reduce(lhs * rhs);
+	}
+
+	// x * M mod P for a non-negative x, the form mul() works on
+	Num enter(FixedBigNum<U> const& x) const {
+		return reduce(Num{mul_mod(x, FixedBigNum<U>{1}, m_mod)} * m_square);
+	}
+
+	FixedBigNum<U> leave(Num const& x) const {
+		auto value = static_cast<FixedBigNum<U>>(reduce(x));
+		return (value >= m_mod) ? (value - m_mod) : value;
+	}
+
+private:
+	FixedBigNum<U>				   m_mod;		 // P
+	std::array<std::uint32_t, 2 * N> m_negInverse; // -P^-1 on B, Montgomery form
+	std::array<std::uint32_t, 2 * N> m_modulus;	 // P on every lane, Montgomery form
+	std::array<std::uint32_t, 2 * N> m_scale;		 // M^-1 on B', Montgomery form
+	Num							   m_square;	 // M^2 mod P
+};
+
+#endif // RNS_H_61C8E3B5A2F04D9B8E7A3C1D6F2B9E47
@@ -0,0 +1,184 @@
+/*
+ * File:      small_vector.h
+ * Author:    Daniel Hannon
+ *
+ * Copyright: 2024 Daniel Hannon
+ *
+ * Brief: SmallVector is an in-memory vector with inline storage.
+ */
+
+#ifndef SMALL_VECTOR_H_9C2E5A7B1F3D4E86B0A4C8D2E6F1B357
+#define SMALL_VECTOR_H_9C2E5A7B1F3D4E86B0A4C8D2E6F1B357 1
+
+#include <algorithm>
+#include <array>
+#include <initializer_list>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include <cstddef>
+
+/*
+ * SmallVector keeps its first N elements inline and only allocates once
+ * it grows past them, so short vectors never touch the heap. It is meant
+ * for trivially copyable elements such as limbs, which lets growth and
+ * copies be plain element copies.
+ */
+template<typename T, std::size_t N>
+struct SmallVector {
+	static_assert(N != 0, "Cannot have 0 inline elements");
+	static_assert(std::is_trivially_copyable_v<T>, "SmallVector only holds trivially copyable types");
+
+	SmallVector() noexcept : m_inline{}, m_heap{}, m_size{0}, m_capacity{N}
+	{}
+
+	SmallVector(std::initializer_list<T> inp) : SmallVector{}
+	{
+		reserve(inp.size());
+		for(auto const& v : inp) {
+			emplace_back(v);
+		}
+	}
+
+	SmallVector(SmallVector const& other) : SmallVector{}
+	{
+		reserve(other.m_size);
+		std::copy_n(other.data(), other.m_size, data());
+		m_size = other.m_size;
+	}
+
+	SmallVector(SmallVector&& other) noexcept : SmallVector{}
+	{
+		swap(other);
+	}
+
+	SmallVector& operator=(SmallVector const& other) {
+		if(this != &other) {
+			// Reuse our own buffer when it is big enough
+			reserve(other.m_size);
+			std::copy_n(other.data(), other.m_size, data());
+			m_size = other.m_size;
+		}
+		return *this;
+	}
+
+	SmallVector& operator=(SmallVector&& other) noexcept {
+		if(this != &other) {
+			swap(other);
+		}
+		return *this;
+	}
+
+	// Amount of elements currently stored in the vector
+	std::size_t size() const noexcept {
+		return m_size;
+	}
+
+	// Elements that fit before the next allocation
+	std::size_t capacity() const noexcept {
+		return m_capacity;
+	}
+
+	bool empty() const noexcept {
+		return m_size == 0;
+	}
+
+	// True while the elements live in the inline buffer
+	bool is_inline() const noexcept {
+		return m_heap == nullptr;
+	}
+
+	T* data() noexcept {
+		return is_inline() ? m_inline.data() : m_heap.get();
+	}
+
+	T const* data() const noexcept {
+		return is_inline() ? m_inline.data() : m_heap.get();
+	}
+
+	T& operator[](std::size_t idx) {
+		return data()[idx];
+	}
+
+	T const& operator[](std::size_t idx) const {
+		return data()[idx];
+	}
+
+	T& at(std::size_t idx) {
+		if(idx >= m_size) {
+			throw std::out_of_range("Element is out of bounds!");
+		}
+		return data()[idx];
+	}
+
+	T& back() {
+		return data()[m_size - 1];
+	}
+
+	T const& back() const {
+		return data()[m_size - 1];
+	}
+
+	T* begin() noexcept { return data(); }
+	T* end() noexcept { return data() + m_size; }
+	T const* begin() const noexcept { return data(); }
+	T const* end() const noexcept { return data() + m_size; }
+
+	// The element is built before growing, args may refer into the old buffer
+	template<class... Args>
+	void emplace_back(Args&&... args) {
+		T val(std::forward<Args>(args)...);
+		if(m_size == m_capacity) {
+			reserve(2 * m_capacity);
+		}
+		data()[m_size++] = val;
+	}
+
+	void push_back(T const& val) {
+		emplace_back(val);
+	}
+
+	void pop_back() {
+		if(m_size == 0) return;
+		m_size--;
+	}
+
+	// Grows or shrinks to count elements, new elements are val
+	void resize(std::size_t count, T const& val = T{}) {
+		reserve(count);
+		if(count > m_size) {
+			std::fill(data() + m_size, data() + count, val);
+		}
+		m_size = count;
+	}
+
+	void reserve(std::size_t count) {
+		if(count <= m_capacity) return;
+		std::unique_ptr<T[]> grown{new T[count]};
+		std::copy_n(data(), m_size, grown.get());
+		m_heap = std::move(grown);
+		m_capacity = count;
+	}
+
+	// Drops the elements but keeps the buffer
+	void clear() noexcept {
+		m_size = 0;
+	}
+
+	void swap(SmallVector& other) noexcept {
+		std::swap(m_inline, other.m_inline);
+		std::swap(m_heap, other.m_heap);
+		std::swap(m_size, other.m_size);
+		std::swap(m_capacity, other.m_capacity);
+	}
+
+private:
+	std::array<T, N>	 m_inline;	 // Inline storage used until the vector outgrows it
+	std::unique_ptr<T[]> m_heap;	 // Heap storage, null while the elements are inline
+	std::size_t			 m_size;	 // The amount of elements stored
+	std::size_t			 m_capacity; // Elements that fit in the active storage
+};
+
+#endif // SMALL_VECTOR_H_9C2E5A7B1F3D4E86B0A4C8D2E6F1B357
@@ -0,0 +1,117 @@
+/*
+ * File:      special_modulus.h
+ * Author:    Daniel Hannon
+ *
+ * Copyright: 2024 Daniel Hannon
+ */
+
+#ifndef SPECIAL_MODULUS_H_C47D2E9A1B8F4A6E9D3C5B7A2E1F0D84
+#define SPECIAL_MODULUS_H_C47D2E9A1B8F4A6E9D3C5B7A2E1F0D84 1
+
+#include "fixed_bignum.h"
+
+#include <algorithm>
+#include <optional>
+
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * Reduction modulo p = 2^k - c for a small c (a negative c gives 2^k + |c|).
+ * Since 2^k is congruent to c, everything above bit k can be folded back
+ * down as x = low + c * high, which is a shift, a scalar multiply and an
+ * add instead of a long division. Mersenne numbers (c = 1) skip the multiply.
+ *
+ * |c| has to fit in 32 bits and k has to be at least 64 so that every fold
+ * shrinks the number. mul() needs 2k bits to fit in U limbs.
+ */
+template<std::size_t U>
+struct SpecialModulus {
+	constexpr SpecialModulus(std::size_t bits, std::int64_t offset) : m_bits{bits}, m_offset{offset}, m_modulus{0}
+	{
+		m_modulus.set_bit(bits);
+		m_modulus -= offset;
+	}
+
+	// Picks out moduli within 2^32 of a power of two, anything else gives nullopt
+	static constexpr std::optional<SpecialModulus> detect(FixedBigNum<U> const& mod) {
+		std::size_t width = mod.bit_width();
+		if(mod.m_signed || (width <= 64) || ((2 * width) > (U * 32))) {
+			return std::nullopt;
+		}
+		// 2^k + c, nothing but the top bit is set above the low limb
+		FixedBigNum<U> rest{mod};
+		rest.set_bit(width - 1, false);
+		if(rest.bit_width() <= 32) {
+			return SpecialModulus{width - 1, -(std::int64_t)rest.low_word()};
+		}
+		// 2^k - c, every bit from 32 up to the top is set
+		if((mod >> 32).popcount() == (width - 32)) {
+			return SpecialModulus{width, (std::int64_t)(((std::uint64_t)1 << 32) - (mod.low_word() & 0xFFFFFFFF))};
+		}
+		return std::nullopt;
+	}
+
+	// Returns x mod p in [0, p), negative inputs included
+	constexpr FixedBigNum<U> reduce(FixedBigNum<U> x) const {
+		while(x.bit_width() > m_bits) {
+			// Fold the magnitude, the sign goes back on afterwards
+			bool sign = x.m_signed;
+			x.m_signed = false;
+			auto high = x >> m_bits;
+			keep_low_bits(x);
+			if(m_offset == 1) {
+				x += high;
+			} else if(m_offset == -1) {
+				x -= high;
+			} else {
+				high *= m_offset;
+				x += high;
+			}
+			x.m_signed = (x.m_signed != sign) && !x.is_zero();
+		}
+		// |x| < 2^k now, so this is at most a couple of corrections
+		while(x.m_signed) {
+			x += m_modulus;
+		}
+		while(x >= m_modulus) {
+			x -= m_modulus;
+		}
+		return x;
+	}
+
+	// (lhs * rhs) mod p, both should already be reduced
+	constexpr FixedBigNum<U> mul(FixedBigNum<U> const& lhs, FixedBigNum<U> const& rhs) const {
+		return reduce(lhs * rhs);
+	}
+
+	constexpr FixedBigNum<U> const& modulus() const {
+		return m_modulus;
+	}
+
+	constexpr std::size_t bits() const {
+		return m_bits;
+	}
+
+	constexpr std::int64_t offset() const {
+		return m_offset;
+	}
+
+private:
+	// x mod 2^k on the magnitude
+	constexpr void keep_low_bits(FixedBigNum<U>& x) const {
+		std::size_t word = m_bits >> 5;
+		if(word > x.m_maxDigit) return;
+		x.m_data[word] &= (1U << (m_bits & 0x1F)) - 1;
+		std::fill(x.m_data.begin() + word + 1, x.m_data.begin() + x.m_maxDigit + 1, 0);
+		x.m_maxDigit = word;
+		x.shrink_max_digit();
+	}
+
+private:
+	std::size_t	   m_bits;	  // k
+	std::int64_t   m_offset;  // c
+	FixedBigNum<U> m_modulus; // 2^k - c
+};
+
+#endif // SPECIAL_MODULUS_H_C47D2E9A1B8F4A6E9D3C5B7A2E1F0D84
@@ -1,11 +1,14 @@
 #include "arbitrary_bignum.h"
 #include "test_helpers.h"
 
+#include <catch2/catch_template_test_macros.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/generators/catch_generators.hpp>
 #include <catch2/generators/catch_generators_adapters.hpp>
 #include <catch2/generators/catch_generators_all.hpp>
+#include <bit>
 #include <cstdint>
+#include <utility>
 
 TEST_CASE("Test ArbitraryBigNum constructor works as expected", "[arbbig_ctor]") {
 	auto a = GENERATE(take(100, random<std::int64_t>(INT64_MIN, INT64_MAX)));
@@ -102,3 +105,356 @@ TEST_CASE("Check ArbitraryBigNum modulo operator works as expected", "[arbbig_mo
 	CHECK(result == expected);
 }
 
+
+TEST_CASE("Check ArbitraryBigNum bit queries work as expected", "[arbbig_bits]") {
+	auto testVals = GENERATE(take(100, pair_random<std::uint64_t>(0U, UINT64_MAX)));
+	std::uint64_t a = GENERATE_COPY(testVals.first, 0);
+	std::size_t bit = testVals.second % 96;
+	ArbitraryBigNum tv1{a};
+	INFO("a = " << a << " bit = " << bit);
+	CHECK(tv1.bit_width() == std::bit_width(a));
+	CHECK(tv1.popcount() == (std::size_t)std::popcount(a));
+	CHECK(tv1.countr_zero() == (a == 0 ? 32 : (std::size_t)std::countr_zero(a)));
+	CHECK(tv1.test_bit(bit) == ((bit < 64) && (((a >> bit) & 1) == 1)));
+	tv1.set_bit(bit);
+	CHECK(tv1.test_bit(bit));
+	CHECK(tv1.bit_width() == std::max<std::size_t>(std::bit_width(a), bit + 1));
+	tv1.set_bit(bit, false);
+	CHECK(tv1 == ArbitraryBigNum{a & ~(bit < 64 ? (1ULL << bit) : 0)});
+}
+
+TEST_CASE("Check ArbitraryBigNum limb import/export round trips", "[arbbig_limbio]") {
+	auto a = GENERATE(take(200, random<std::uint64_t>(0, UINT64_MAX)));
+	auto order = GENERATE(WordOrder::least_significant_first, WordOrder::most_significant_first);
+	auto endian = GENERATE(std::endian::little, std::endian::big);
+	ArbitraryBigNum<> binary{a};
+	ArbitraryBigNum<ARBITRARY_PRINTABLE> decimal{a};
+	INFO("a = " << a);
+
+	std::uint16_t halves[4];
+	binary.export_limbs(halves, 4, order, endian);
+	CHECK(ArbitraryBigNum<>{}.import_limbs(halves, 4, order, endian) == binary);
+	std::uint64_t word = 0;
+	decimal.export_limbs(&word, 1, order, endian);
+	CHECK((endian == std::endian::native ? word : word_byteswap(word)) == a);
+	CHECK(ArbitraryBigNum<ARBITRARY_PRINTABLE>{}.import_limbs(&word, 1, order, endian) == decimal);
+	CHECK(decimal.export_size<std::uint8_t>() == (std::bit_width(a) + 7) / 8);
+}
+
+TEST_CASE("Check ArbitraryBigNum divexact undoes multiplication", "[arbbig_divexact]") {
+	auto testVals = GENERATE(take(200, pair_random<std::int64_t>(INT64_MIN, INT64_MAX)));
+	ArbitraryBigNum<> a{testVals.first};
+	ArbitraryBigNum<> b{testVals.second};
+	ArbitraryBigNum<ARBITRARY_PRINTABLE> c{testVals.first};
+	ArbitraryBigNum<ARBITRARY_PRINTABLE> d{testVals.second};
+	INFO("a = " << testVals.first << " b = " << testVals.second);
+	CHECK((a * a * b).divexact(b) == (a * a));
+	CHECK((c * d * d).divexact(c) == (d * d));
+}
+
+TEST_CASE("Check ArbitraryBigNum mul_high is the shifted product or one below", "[arbbig_mulhigh]") {
+	auto testVals = GENERATE(take(200, pair_random<std::int64_t>(INT64_MIN + 1, INT64_MAX)));
+	auto a = grown_number<ArbitraryBigNum<>>(testVals.first, testVals.second, 4);
+	ArbitraryBigNum<> b{testVals.second};
+	// Both sides past limb_mul_high_limbs, or one short of it
+	bool shortSide = GENERATE(false, true);
+	b = shortSide ? (b * b * b * testVals.first) : ((a * 3) - b);
+	std::size_t total = a.export_size<std::uint32_t>() + b.export_size<std::uint32_t>();
+	INFO("a = " << testVals.first << " b = " << testVals.second);
+	for(std::size_t k : {std::size_t{1}, std::size_t{5}, total / 2, total}) {
+		auto expected = (a * b) >> (32 * (total - k));
+		auto high = mul_high(a, b, k);
+		CHECK(signbit(high) == signbit(expected));
+		auto diff = abs(expected) - abs(high);
+		CHECK(((diff == 0) || (diff == 1)));
+		// Other bases go through binary limbs, the answer is the same number
+		ArbitraryBigNum<ARBITRARY_PRINTABLE> c{a};
+		ArbitraryBigNum<ARBITRARY_PRINTABLE> d{b};
+		CHECK(ArbitraryBigNum<>{mul_high(c, d, k)} == high);
+	}
+}
+
+TEST_CASE("Check ArbitraryBigNum gives the same answers in cold storage", "[arbbig_storage]") {
+	auto testVals = GENERATE(take(20, pair_random<std::int64_t>(INT64_MIN + 1, INT64_MAX)));
+	auto a = grown_number<ArbitraryBigNum<>>(testVals.first, testVals.second, 7);
+	// Squaring past the 100 digit buffer makes the cold copies go through the file
+	auto b = grown_number<ArbitraryBigNum<UINT32_MAX, ColdLimbs>>(testVals.first, testVals.second, 7);
+	INFO("a = " << testVals.first << " b = " << testVals.second);
+	CHECK(ArbitraryBigNum<>{b} == a);
+	CHECK(ArbitraryBigNum<UINT32_MAX, ColdLimbs>{a} == b);
+	CHECK(ArbitraryBigNum<>{b >> 100} == (a >> 100));
+	CHECK(ArbitraryBigNum<>{b / (b >> 2000)} == (a / (a >> 2000)));
+	ArbitraryBigNum<ARBITRARY_PRINTABLE, ColdLimbs> c{a};
+	CHECK(ArbitraryBigNum<>{c} == a);
+}
+
+TEST_CASE("Check ArbitraryBigNum large products agree across bases", "[arbbig_bigmul]") {
+	auto testVals = GENERATE(take(10, pair_random<std::int64_t>(INT64_MIN + 1, INT64_MAX)));
+	// Up to several hundred limbs, past the Karatsuba and Toom-3 thresholds
+	auto [a, b] = grown_operands<ArbitraryBigNum<>>(testVals.first, testVals.second, 8, 3000);
+	INFO("a = " << testVals.first << " b = " << testVals.second);
+	ArbitraryBigNum<ARBITRARY_PRINTABLE> c{a};
+	ArbitraryBigNum<ARBITRARY_PRINTABLE> d{b};
+	auto product = a * b;
+	CHECK(ArbitraryBigNum<>{c * d} == product);
+	CHECK((product - (a * 2) * b + a * b) == 0);
+	CHECK((a * b) == (b * a));
+}
+
+TEMPLATE_TEST_CASE_SIG("Check ArbitraryBigNum long division works in every base", "[arbbig_longdiv]", ((std::size_t MAX_VAL), MAX_VAL),
+					   UINT32_MAX, ARBITRARY_PRINTABLE, 9, 1) {
+	using Num = ArbitraryBigNum<MAX_VAL>;
+	auto testVals = GENERATE(take(100, pair_random<std::int64_t>(INT64_MIN + 1, INT64_MAX)));
+	auto a = grown_number<ArbitraryBigNum<>>(testVals.first, testVals.second, 4);
+	ArbitraryBigNum<> b{testVals.second};
+	b = b * b * testVals.first + 1;
+	INFO("base = " << MAX_VAL << " a = " << testVals.first << " b = " << testVals.second);
+	// q * d + r == n with |r| < |d|, r carrying the sign of n
+	for(auto [num, div] : {std::pair{Num{a}, Num{b}}, std::pair{Num{b}, Num{testVals.first}}}) {
+		auto quot = num / div;
+		auto rem = num % div;
+		CHECK((quot * div + rem) == num);
+		CHECK(absolute_compare(rem, div) == std::strong_ordering::less);
+		CHECK(((rem == 0) || (signbit(rem) == signbit(num))));
+	}
+	// Every base gives the same quotient
+	CHECK(ArbitraryBigNum<>{Num{a} / Num{b}} == (a / b));
+}
+
+TEST_CASE("Check ArbitraryBigNum decimal division matches the built in types", "[arbbig_decdiv]") {
+	auto testVals = GENERATE(take(1000, pair_random<std::int64_t>(INT64_MIN, INT64_MAX)));
+	std::int64_t a = testVals.first;
+	std::int64_t b = testVals.second >> (testVals.first & 0x3F);
+	if(b == 0) b = 7;
+	ArbitraryBigNum<ARBITRARY_PRINTABLE> tv1{a};
+	ArbitraryBigNum<ARBITRARY_PRINTABLE> tv2{b};
+	INFO("a = " << a << " b = " << b);
+	CHECK((tv1 / tv2) == ArbitraryBigNum<ARBITRARY_PRINTABLE>{a / b});
+	CHECK((tv1 % tv2) == ArbitraryBigNum<ARBITRARY_PRINTABLE>{a % b});
+}
+
+TEST_CASE("Check ArbitraryBigNum division by a scalar drops leading zeroes", "[arbbig_scalardiv]") {
+	auto testVals = GENERATE(take(100, pair_random<std::int32_t>(INT32_MIN + 1, INT32_MAX)));
+	std::int64_t a = (std::int64_t)testVals.first * testVals.second;
+	std::int32_t b = (testVals.second == 0) ? 3 : testVals.second;
+	ArbitraryBigNum<ARBITRARY_PRINTABLE> tv1{a};
+	INFO("a = " << a << " b = " << b);
+	CHECK((tv1 / b) == ArbitraryBigNum<ARBITRARY_PRINTABLE>{a / b});
+	CHECK((ArbitraryBigNum<>{a} / b) == (a / b));
+}
+
+static_assert(std::is_nothrow_move_constructible_v<ArbitraryBigNum<>>);
+static_assert(std::is_nothrow_move_assignable_v<ArbitraryBigNum<>>);
+static_assert(std::is_nothrow_move_constructible_v<ArbitraryBigNum<UINT32_MAX, ColdLimbs>>);
+static_assert(std::is_nothrow_move_assignable_v<ArbitraryBigNum<UINT32_MAX, ColdLimbs>>);
+
+// Every mix of lvalue and temporary operands has to match the plain answer
+TEMPLATE_TEST_CASE_SIG("Check ArbitraryBigNum reuses temporaries correctly", "[arbbig_move]", ((std::size_t MAX_VAL, typename Storage), MAX_VAL, Storage),
+					   (UINT32_MAX, InMemoryLimbs), (ARBITRARY_PRINTABLE, InMemoryLimbs), (UINT32_MAX, ColdLimbs)) {
+	auto x = GENERATE(take(20, random<std::int32_t>(INT32_MIN + 1, INT32_MAX)));
+	auto y = GENERATE(take(3, random<std::int32_t>(INT32_MIN + 1, INT32_MAX)));
+	auto z = GENERATE(take(3, random<std::int32_t>(INT32_MIN + 1, INT32_MAX)));
+	INFO("base = " << MAX_VAL << " x = " << x << " y = " << y << " z = " << z);
+	using Num = ArbitraryBigNum<MAX_VAL, Storage>;
+	Num a{x};
+	Num b{y};
+	Num c{z};
+	std::int64_t a64 = x;
+	std::int64_t b64 = y;
+	std::int64_t c64 = z;
+	CHECK((a + b + c) == (a64 + b64 + c64));
+	CHECK((a + (b + c)) == (a64 + b64 + c64));
+	CHECK(((a + b) + (b + c)) == (a64 + (2 * b64) + c64));
+	CHECK((a - b - c) == (a64 - b64 - c64));
+	CHECK((a - (b - c)) == (a64 - (b64 - c64)));
+	CHECK((a - (a + 0)) == 0);
+	CHECK(!signbit(a - (a + 0)));
+	CHECK(((a - b) - (c - b)) == (a64 - c64));
+	CHECK(((a * b) * c) == ((a * b64) * c64));
+	CHECK((a * (b * c)) == ((a * b64) * c64));
+	CHECK(((a * b) * (b * c)) == ((a * b64) * (b64 * c64)));
+	CHECK(((a + b) * z) == ((a64 + b64) * c64));
+	CHECK(((a + b) * 0) == 0);
+
+	Num d{a};
+	Num e{std::move(d)};
+	d = b;
+	CHECK(e == a);
+	CHECK(d == b);
+	e = std::move(d);
+	CHECK(e == b);
+	d = c;
+	CHECK(d == c);
+}
+
+// Blocked products with a tiny budget have to match the in-memory product
+TEMPLATE_TEST_CASE_SIG("Check ArbitraryBigNum out of core products", "[arbbig_outofcore]", ((std::size_t MAX_VAL, typename Storage), MAX_VAL, Storage),
+					   (UINT32_MAX, InMemoryLimbs), (UINT32_MAX, ColdLimbs), (ARBITRARY_PRINTABLE, ColdLimbs), (1, InMemoryLimbs)) {
+	auto testVals = GENERATE(take(4, pair_random<std::int64_t>(INT64_MIN + 1, INT64_MAX)));
+	// Base 2 spends a digit per bit, keep its operands small
+	std::int64_t x = (MAX_VAL == 1) ? (testVals.first % 1000) : testVals.first;
+	std::int64_t y = (MAX_VAL == 1) ? (testVals.second % 1000) : testVals.second;
+	INFO("base = " << MAX_VAL << " x = " << x << " y = " << y);
+	auto [a, b] = grown_operands<ArbitraryBigNum<MAX_VAL>>(x, y, 5, 700);
+	ArbitraryBigNum<MAX_VAL, Storage> c{a};
+	ArbitraryBigNum<MAX_VAL, Storage> d{b};
+	for(std::size_t budget : {1, 8, 40, 200, 1 << 20}) {
+		INFO("budget = " << budget);
+		CHECK(ArbitraryBigNum<MAX_VAL>{mul_out_of_core(c, d, budget)} == (a * b));
+		CHECK(ArbitraryBigNum<MAX_VAL>{mul_out_of_core(d, c, budget)} == (a * b));
+		CHECK(ArbitraryBigNum<MAX_VAL>{mul_out_of_core(c, c, budget)} == (a * a));
+		CHECK(ArbitraryBigNum<MAX_VAL>{mul_out_of_core(c, ArbitraryBigNum<MAX_VAL, Storage>{y}, budget)} == (a * y));
+	}
+	CHECK(mul_out_of_core(c, ArbitraryBigNum<MAX_VAL, Storage>{0}, 64) == 0);
+	CHECK(!signbit(mul_out_of_core(ArbitraryBigNum<MAX_VAL, Storage>{0} - c, ArbitraryBigNum<MAX_VAL, Storage>{0}, 64)));
+	CHECK(signbit(mul_out_of_core(ArbitraryBigNum<MAX_VAL, Storage>{0} - c, d, 64)) == (signbit(a) == signbit(b)));
+}
+
+TEST_CASE("Check ArbitraryBigNum export_decimal matches the printed value", "[arbbig_export]") {
+	auto testVals = GENERATE(take(20, pair_random<std::int64_t>(INT64_MIN + 1, INT64_MAX)));
+	for(std::int64_t val : {testVals.first, testVals.second, std::int64_t{0}, std::int64_t{-1000000000}}) {
+		std::stringstream binary;
+		std::stringstream decimal;
+		std::stringstream base10;
+		CHECK(ArbitraryBigNum<>{val}.export_decimal(binary));
+		CHECK(ArbitraryBigNum<ARBITRARY_PRINTABLE>{val}.export_decimal(decimal));
+		CHECK(ArbitraryBigNum<9>{val}.export_decimal(base10));
+		CHECK(binary.str() == std::to_string(val));
+		CHECK(decimal.str() == std::to_string(val));
+		CHECK(base10.str() == std::to_string(val));
+	}
+
+	// Several thousand digits, far past the conversion's split point and the write buffer
+	auto a = grown_number<ArbitraryBigNum<>>(testVals.first, testVals.second, 10);
+	// Reference text from peeling off 9 digits at a time
+	std::vector<std::uint32_t> groups;
+	for(auto rest = abs(a); rest != 0; rest /= 1000000000U) {
+		std::uint32_t group = 0;
+		(rest - ((rest / 1000000000U) * 1000000000U)).export_limbs(&group, 1);
+		groups.push_back(group);
+	}
+	std::stringstream expected;
+	expected << (signbit(a) ? "-" : "") << groups.back();
+	for(std::size_t idx = groups.size() - 1; idx > 0; idx--) {
+		expected << std::setw(9) << std::setfill('0') << groups[idx - 1];
+	}
+	std::stringstream result;
+	CHECK(a.export_decimal(result));
+	INFO("a = " << testVals.first << " b = " << testVals.second);
+	CHECK(result.str() == expected.str());
+	std::stringstream printed;
+	printed << a;
+	CHECK(printed.str() == expected.str());
+
+	std::string path = "arbbig_export_test.txt";
+	CHECK(ArbitraryBigNum<UINT32_MAX, ColdLimbs>{a}.export_decimal(path));
+	std::ifstream file{path};
+	std::stringstream contents;
+	contents << file.rdbuf();
+	file.close();
+	std::remove(path.c_str());
+	CHECK(contents.str() == expected.str());
+}
+
+TEST_CASE("Check ArbitraryBigNum import_decimal reads what export_decimal writes", "[arbbig_import]") {
+	auto testVals = GENERATE(take(20, pair_random<std::int64_t>(INT64_MIN + 1, INT64_MAX)));
+	for(std::int64_t val : {testVals.first, testVals.second, std::int64_t{0}, std::int64_t{-1000000000}}) {
+		std::stringstream text{"  " + std::to_string(val) + " tail"};
+		ArbitraryBigNum<> a{5};
+		ArbitraryBigNum<ARBITRARY_PRINTABLE> b{5};
+		ArbitraryBigNum<9, ColdLimbs> c{5};
+		CHECK(a.import_decimal(text));
+		std::string rest;
+		text >> rest;
+		CHECK(rest == "tail");
+		text.str(std::to_string(val));
+		text.clear();
+		CHECK(b.import_decimal(text));
+		CHECK(text.eof());
+		text.str(std::to_string(val));
+		text.clear();
+		CHECK(c.import_decimal(text));
+		CHECK(a == val);
+		CHECK(b == ArbitraryBigNum<ARBITRARY_PRINTABLE>{val});
+		CHECK(c == ArbitraryBigNum<9, ColdLimbs>{val});
+	}
+
+	std::stringstream text{"+00012"};
+	ArbitraryBigNum<> a{5};
+	CHECK(a.import_decimal(text));
+	CHECK(a == 12);
+	for(std::string bad : {"", "-", "x12", " + 3"}) {
+		std::stringstream badText{bad};
+		CHECK(!a.import_decimal(badText));
+		CHECK(badText.fail());
+		CHECK(a == 12);
+	}
+
+	// Several thousand digits through a file, every group boundary lands somewhere new
+	auto big = grown_number<ArbitraryBigNum<>>(testVals.first, testVals.second, 10);
+	std::string path = "arbbig_import_test.txt";
+	for(std::size_t shift = 0; shift < 9; shift++) {
+		big = big * 10 + (std::int32_t)shift;
+		CHECK(big.export_decimal(path));
+		ArbitraryBigNum<> binary{0};
+		ArbitraryBigNum<ARBITRARY_PRINTABLE, ColdLimbs> printable{0};
+		CHECK(binary.import_decimal(path));
+		CHECK(printable.import_decimal(path));
+		CHECK(binary == big);
+		CHECK(ArbitraryBigNum<>{printable} == big);
+	}
+	std::remove(path.c_str());
+	CHECK(!a.import_decimal(path));
+}
+
+TEST_CASE("Check ArbitraryBigNum export_decimal of cold numbers converts in blocks", "[arbbig_coldexport]") {
+	auto testVals = GENERATE(take(3, pair_random<std::int64_t>(INT64_MIN + 1, INT64_MAX)));
+	auto a = grown_number<ArbitraryBigNum<>>(testVals.first, testVals.second, 10) * -1;
+	std::stringstream expected;
+	CHECK(a.export_decimal(expected));
+	INFO("a = " << testVals.first << " b = " << testVals.second);
+	// Budgets small enough that every conversion splits several levels deep
+	for(std::size_t budget : {512, 4096}) {
+		INFO("budget = " << budget);
+		std::stringstream binary;
+		std::stringstream base10;
+		CHECK(ArbitraryBigNum<UINT32_MAX, ColdLimbs>{a}.export_decimal(binary, budget));
+		CHECK(ArbitraryBigNum<9, ColdLimbs>{a}.export_decimal(base10, budget));
+		CHECK(binary.str() == expected.str());
+		CHECK(base10.str() == expected.str());
+	}
+}
+
+TEST_CASE("Check ArbitraryBigNum import_decimal of long text into cold numbers converts in blocks", "[arbbig_coldimport]") {
+	auto testVals = GENERATE(take(3, pair_random<std::int64_t>(INT64_MIN + 1, INT64_MAX)));
+	auto a = grown_number<ArbitraryBigNum<>>(testVals.first, testVals.second, 10) * -1;
+	std::stringstream expected;
+	CHECK(a.export_decimal(expected));
+	auto shifted = (a * 10000) - 1234;
+	INFO("a = " << testVals.first << " b = " << testVals.second);
+	// Budgets small enough that the groups spill and every conversion splits several levels deep
+	for(std::size_t budget : {512, 4096}) {
+		INFO("budget = " << budget);
+		ArbitraryBigNum<UINT32_MAX, ColdLimbs> binary{5};
+		ArbitraryBigNum<ARBITRARY_PRINTABLE, ColdLimbs> decimal{5};
+		ArbitraryBigNum<9, ColdLimbs> base10{5};
+		std::stringstream text{expected.str() + "1234"};
+		CHECK(binary.import_decimal(text, budget));
+		text.str(expected.str() + "1234");
+		text.clear();
+		CHECK(decimal.import_decimal(text, budget));
+		text.str(expected.str() + "1234");
+		text.clear();
+		CHECK(base10.import_decimal(text, budget));
+		CHECK(ArbitraryBigNum<>{binary} == shifted);
+		CHECK(ArbitraryBigNum<>{decimal} == shifted);
+		CHECK(ArbitraryBigNum<>{base10} == shifted);
+	}
+
+	// Long runs of zeroes still come out as a plain zero
+	ArbitraryBigNum<UINT32_MAX, ColdLimbs> zero{5};
+	std::stringstream zeroes{"-" + std::string(20000, '0')};
+	CHECK(zero.import_decimal(zeroes, 512));
+	CHECK(zero == 0);
+	CHECK(!signbit(zero));
+}
@@ -0,0 +1,124 @@
+#include "binary_poly.h"
+#include "test_helpers.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <catch2/generators/catch_generators_adapters.hpp>
+#include <catch2/generators/catch_generators_all.hpp>
+#include <cstdint>
+#include <stdexcept>
+
+using TestType = FixedBigNum<80>;
+
+// Carry-less product by shifting and XORing, truncated to U limbs
+template<std::size_t U>
+static FixedBigNum<U> reference_clmul(FixedBigNum<U> const& lhs, FixedBigNum<U> const& rhs) {
+	FixedBigNum<U> result{0};
+	for(std::size_t bit = 0; bit < rhs.bit_width(); bit++) {
+		if(rhs.test_bit(bit)) {
+			result ^= lhs << bit;
+		}
+	}
+	return result;
+}
+
+// val mod f by clearing the top bit one at a time
+template<std::size_t U>
+static FixedBigNum<U> reference_reduce(FixedBigNum<U> val, std::size_t degree, std::initializer_list<std::size_t> taps) {
+	while(val.bit_width() > degree) {
+		std::size_t shift = val.bit_width() - 1 - degree;
+		val.set_bit(degree + shift, false);
+		for(auto tap : taps) {
+			val ^= FixedBigNum<U>{1} << (tap + shift);
+		}
+	}
+	return val;
+}
+
+// Polynomial of roughly limbs * 32 bits built out of the pair
+static TestType make_poly(std::int64_t a, std::int64_t b, std::size_t limbs) {
+	TestType value{0};
+	std::uint64_t state = ((std::uint64_t)a * 0x9E3779B97F4A7C15ULL) ^ (std::uint64_t)b;
+	for(std::size_t idx = 0; idx < limbs; idx++) {
+		state = (state * 6364136223846793005ULL) + 1442695040888963407ULL;
+		value <<= 32;
+		value += (std::uint32_t)(state >> 32);
+	}
+	return value;
+}
+
+TEST_CASE("Test clmul matches shift and XOR", "[clmul]") {
+	auto testVals = GENERATE(take(100, pair_random<std::int64_t>(INT64_MIN, INT64_MAX)));
+	// Both sides of the Karatsuba threshold, and lopsided lengths
+	auto sizes = GENERATE(std::pair<std::size_t, std::size_t>{1, 1}, std::pair<std::size_t, std::size_t>{3, 7}, std::pair<std::size_t, std::size_t>{15, 15},
+						  std::pair<std::size_t, std::size_t>{16, 16}, std::pair<std::size_t, std::size_t>{37, 21}, std::pair<std::size_t, std::size_t>{40, 40});
+	auto lhs = make_poly(testVals.first, testVals.second, sizes.first);
+	auto rhs = make_poly(testVals.second, testVals.first, sizes.second);
+	CHECK(clmul(lhs, rhs) == reference_clmul(lhs, rhs));
+	CHECK(clmul(rhs, lhs) == reference_clmul(lhs, rhs));
+	CHECK(clsquare(lhs) == reference_clmul(lhs, lhs));
+}
+
+TEST_CASE("Test clmul small values", "[clmul_small]") {
+	// (x + 1)^2 = x^2 + 1
+	CHECK(clmul(TestType{3}, TestType{3}) == TestType{5});
+	CHECK(clsquare(TestType{3}) == TestType{5});
+	// (x^2 + x + 1)(x + 1) = x^3 + 1
+	CHECK(clmul(TestType{7}, TestType{3}) == TestType{9});
+	CHECK(clmul(TestType{0}, TestType{12345}) == TestType{0});
+	CHECK(clmul(TestType{-7}, TestType{3}) == TestType{9});
+	// Truncated to U limbs like operator*
+	auto top = TestType{1} << (80 * 32 - 1);
+	CHECK(clmul(top, TestType{2}) == TestType{0});
+}
+
+TEST_CASE("Test SparsePolyModulus matches reference reduction", "[clmul_reduce]") {
+	auto testVals = GENERATE(take(50, pair_random<std::int64_t>(INT64_MIN, INT64_MAX)));
+	// GHASH pentanomial, a NIST trinomial and a wide trinomial that takes the Karatsuba path
+	SparsePolyModulus<80> ghash{128, {7, 2, 1, 0}};
+	SparsePolyModulus<80> b233{233, {74, 0}};
+	SparsePolyModulus<80> wide{1279, {216, 0}};
+
+	auto value = make_poly(testVals.first, testVals.second, 78);
+	CHECK(ghash.reduce(value) == reference_reduce(value, 128, {7, 2, 1, 0}));
+	CHECK(b233.reduce(value) == reference_reduce(value, 233, {74, 0}));
+	CHECK(wide.reduce(value) == reference_reduce(value, 1279, {216, 0}));
+
+	for(auto const* field : {&ghash, &b233, &wide}) {
+		auto lhs = field->reduce(make_poly(testVals.first, 7, 40));
+		auto rhs = field->reduce(make_poly(testVals.second, 11, 40));
+		CHECK(field->mul(lhs, rhs) == field->reduce(reference_clmul(lhs, rhs)));
+		CHECK(field->square(lhs) == field->mul(lhs, lhs));
+		CHECK(field->mul(lhs, rhs).bit_width() <= field->degree());
+	}
+}
+
+TEST_CASE("Test SparsePolyModulus field identities", "[clmul_field]") {
+	// x^(2^n) = x in GF(2^n), so squaring x n times comes back to x
+	SparsePolyModulus<80> b233{233, {74, 0}};
+	TestType x{2};
+	TestType power{x};
+	for(std::size_t idx = 0; idx < 233; idx++) {
+		power = b233.square(power);
+	}
+	CHECK(power == x);
+
+	// Any non-zero a has a^(2^n - 1) = 1
+	SparsePolyModulus<80> ghash{128, {7, 2, 1, 0}};
+	auto a = ghash.reduce(make_poly(12345, 678, 5));
+	TestType acc{1};
+	TestType square{a};
+	for(std::size_t idx = 0; idx < 128; idx++) {
+		acc = ghash.mul(acc, square);
+		square = ghash.square(square);
+	}
+	CHECK(acc == TestType{1});
+}
+
+TEST_CASE("Test SparsePolyModulus rejects moduli it can't reduce by", "[clmul_badmod]") {
+	CHECK_THROWS_AS((SparsePolyModulus<4>{128, {7, 2, 1, 0, 0}}), std::invalid_argument);
+	CHECK_THROWS_AS((SparsePolyModulus<4>{128, {128, 0}}), std::invalid_argument);
+	CHECK_THROWS_AS((SparsePolyModulus<4>{128, {200}}), std::invalid_argument);
+	CHECK_THROWS_AS((SparsePolyModulus<4>{129, {7, 0}}), std::invalid_argument);
+	CHECK_NOTHROW((SparsePolyModulus<4>{128, {127, 0}}));
+}
@@ -92,3 +92,41 @@ TEST_CASE("Test Insert operator works as expected", "[coldvec_insert]") {
 	}
 }
 
+
+TEST_CASE("Test ColdVector borrowing a file", "[coldvec_borrow]") {
+	std::string name = "coldvec_borrow.bin";
+	{
+		std::ofstream file{name, std::ios::out | std::ios::binary | std::ios::trunc};
+		file.write("HEADER", 6);
+		for(int val = 0; val < 250; val++) {
+			file.write(reinterpret_cast<char const*>(&val), sizeof(val));
+		}
+	}
+	{
+		ColdVector<int> borrowed{name, 6, 250};
+		ColdVector<int> const& view = borrowed;
+		CHECK(borrowed.size() == 250);
+		CHECK(view[0] == 0);
+		CHECK(view[249] == 249);
+		CHECK(view[120] == 120);
+
+		// Writes go to a copy, the borrowed file never changes
+		borrowed[3] = -3;
+		borrowed.emplace_back(250);
+		CHECK(borrowed[249] == 249);
+		CHECK(borrowed[3] == -3);
+		CHECK(borrowed[250] == 250);
+		ColdVector<int> copy{borrowed};
+		CHECK(copy[3] == -3);
+		CHECK(copy[120] == 120);
+	}
+	std::ifstream file{name, std::ios::in | std::ios::binary};
+	REQUIRE(file.is_open());
+	file.seekg(6 + (3 * sizeof(int)), std::ios::beg);
+	int val = 0;
+	file.read(reinterpret_cast<char*>(&val), sizeof(val));
+	CHECK(val == 3);
+	file.close();
+	std::remove(name.c_str());
+	CHECK_THROWS_AS((ColdVector<int>{name, 0, 1}), std::runtime_error);
+}
@@ -0,0 +1,184 @@
+#include "digit_kernels.h"
+#include "test_helpers.h"
+
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <catch2/generators/catch_generators_adapters.hpp>
+#include <catch2/generators/catch_generators_all.hpp>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+static std::vector<std::uint32_t> random_digits(std::minstd_rand& rng, std::uint64_t base, std::size_t len, bool saturated) {
+	std::uniform_int_distribution<std::uint64_t> dist{0, base - 1};
+	std::vector<std::uint32_t> digits(len);
+	for(auto& digit : digits) {
+		digit = (saturated ? (base - 1) : dist(rng)) & 0xFFFFFFFF;
+	}
+	return digits;
+}
+
+// Plain schoolbook multiplication with a division per partial product to check the kernels against
+template<std::uint64_t BASE>
+static std::vector<std::uint32_t> reference_mul(std::vector<std::uint32_t> const& lhs, std::vector<std::uint32_t> const& rhs) {
+	std::vector<std::uint32_t> res(lhs.size() + rhs.size(), 0);
+	for(std::size_t idx = 0; idx < rhs.size(); idx++) {
+		std::uint64_t carry = 0;
+		for(std::size_t idy = 0; idy < lhs.size(); idy++) {
+			carry += ((std::uint64_t)lhs[idy] * rhs[idx]) + res[idx + idy];
+			res[idx + idy] = carry % BASE;
+			carry /= BASE;
+		}
+		res[idx + lhs.size()] = carry;
+	}
+	return res;
+}
+
+// 4294967296 is the binary base 2^32
+TEMPLATE_TEST_CASE_SIG("Test digit_mul matches schoolbook multiplication in every base", "[digit_mul]", ((std::uint64_t BASE), BASE),
+					   4294967296ULL, 1000000000, UINT32_MAX, 10, 7, 3, 2) {
+	// Random lengths and lengths either side of both thresholds
+	std::size_t len = GENERATE(take(10, random<std::size_t>(1, 400)),
+							   range(digit_karatsuba_limbs<BASE> - 2, digit_karatsuba_limbs<BASE> + 3),
+							   range(digit_toom3_limbs<BASE> - 2, digit_toom3_limbs<BASE> + 3));
+	std::minstd_rand rng{(std::uint32_t)len};
+	// Uneven operands go a block at a time
+	for(std::size_t lhsLen : {len, (3 * len) + 1}) {
+		// All maximal digits push every carry and every evaluation to its limit
+		for(bool saturated : {false, true}) {
+			auto lhs = random_digits(rng, BASE, lhsLen, saturated);
+			auto rhs = random_digits(rng, BASE, len, saturated);
+			auto expected = reference_mul<BASE>(lhs, rhs);
+			std::vector<std::uint32_t> result(lhsLen + len);
+			digit_mul<BASE>(result.data(), lhs.data(), lhsLen, rhs.data(), len);
+			INFO("base = " << BASE << " lhsLen = " << lhsLen << " rhsLen = " << len << " saturated = " << saturated);
+			CHECK(result == expected);
+		}
+	}
+}
+
+// 4294967296 is the binary base 2^32
+TEMPLATE_TEST_CASE_SIG("Test DigitAccumulator matches carrying every term", "[digit_accumulator]", ((std::uint64_t BASE), BASE),
+					   4294967296ULL, 1000000000, UINT32_MAX, 10, 2) {
+	std::uint32_t seed = GENERATE(take(10, random(1U, 10000U)));
+	std::minstd_rand rng{seed};
+	// Enough rows and terms that the lanes have to be settled part way through
+	std::size_t width = 80;
+	std::vector<std::uint32_t> expected(width + 1, 0);
+	DigitAccumulator<BASE> acc;
+	for(std::size_t term = 0; term < 40; term++) {
+		bool saturated = (term % 4) == 0;
+		std::size_t lhsLen = (rng() % 30) + 1;
+		std::size_t rhsLen = (rng() % 50) + 1;
+		auto lhs = random_digits(rng, BASE, lhsLen, saturated);
+		auto rhs = random_digits(rng, BASE, rhsLen, saturated);
+		auto product = reference_mul<BASE>(lhs, rhs);
+		digit_add_at<BASE>(expected.data(), expected.size(), 0, product.data(), product.size());
+		digit_add_at<BASE>(expected.data(), expected.size(), 0, lhs.data(), lhsLen);
+		acc.addmul(lhs.data(), lhsLen, rhs.data(), rhsLen);
+		acc.add(lhs.data(), lhsLen);
+	}
+	expected.resize(std::max<std::size_t>(limb_active_length(expected.data(), expected.size()), 1));
+	INFO("base = " << BASE << " seed = " << seed);
+	CHECK(acc.result() == expected);
+	CHECK(DigitAccumulator<BASE>{}.result() == std::vector<std::uint32_t>{0});
+}
+
+TEST_CASE("Test digit_divmod_1 and digit_mul_1 undo each other", "[digit_mul_1]") {
+	std::minstd_rand rng{42};
+	auto digits = random_digits(rng, 1000000000, 20, false);
+	digits.push_back(0);
+	auto copy = digits;
+	CHECK(digit_mul_1<1000000000>(digits.data(), digits.size(), 7) == 0);
+	CHECK(digit_divmod_1<1000000000>(digits.data(), digits.size(), 7) == 0);
+	CHECK(digits == copy);
+}
+
+// 4294967296 is the binary base 2^32
+TEMPLATE_TEST_CASE_SIG("Test digit_div_base matches division for every 64 bit value", "[digit_div_base]", ((std::uint64_t BASE), BASE),
+					   1000000000, 10, 3, 1000, UINT32_MAX, 4294967296ULL) {
+	std::minstd_rand rng{7};
+	std::uniform_int_distribution<std::uint64_t> dist{0, UINT64_MAX};
+	for(std::uint64_t x : {std::uint64_t{0}, BASE - 1, BASE, (BASE * BASE) - 1, UINT64_MAX, UINT64_MAX - 1}) {
+		CHECK(digit_div_base<BASE>(x) == (x / BASE));
+	}
+	for(std::size_t idx = 0; idx < 10000; idx++) {
+		std::uint64_t x = dist(rng) >> (idx % 64);
+		std::uint32_t digit = 0;
+		INFO("base = " << BASE << " x = " << x);
+		CHECK(digit_split<BASE>(x, digit) == (x / BASE));
+		CHECK(digit == (x % BASE));
+	}
+}
+
+static_assert(digit_div_base<1000000000>(UINT64_MAX) == (UINT64_MAX / 1000000000));
+static_assert(digit_lazy_rows<1000000000> == 18);
+
+// 4294967296 is the binary base 2^32
+TEMPLATE_TEST_CASE_SIG("Test digit_divmod_n in every base", "[digit_divmod]", ((std::uint64_t BASE), BASE),
+					   4294967296ULL, 1000000000, UINT32_MAX, 10, 2) {
+	auto testVals = GENERATE(take(100, pair_random<std::uint32_t>(1U, 60U)));
+	std::size_t divLen = std::min(testVals.first, testVals.second);
+	std::size_t numLen = std::max(testVals.first, testVals.second);
+	std::uint32_t seed = testVals.first * 61 + testVals.second;
+	std::minstd_rand rng{seed};
+	auto num = random_digits(rng, BASE, numLen, false);
+	auto div = random_digits(rng, BASE, divLen, seed % 3 == 0);
+	// A small top digit makes the scaling do the most work
+	div.back() = std::max<std::uint32_t>(div.back() >> (seed % 31), 1);
+	auto original = num;
+	auto divisor = div;
+	num.push_back(0);
+	std::vector<std::uint32_t> quot(numLen - divLen + 1);
+	digit_divmod_n<BASE>(quot.data(), num.data(), numLen, div.data(), divLen);
+	INFO("base = " << BASE << " numLen = " << numLen << " divLen = " << divLen);
+	CHECK(div == divisor);
+	// The remainder is below the divisor and quot * div + rem gives num back
+	CHECK(digit_cmp_n(num.data(), div.data(), divLen) < 0);
+	std::vector<std::uint32_t> check(quot.size() + divLen);
+	digit_mul_basecase<BASE>(check.data(), quot.data(), quot.size(), div.data(), divLen);
+	digit_add_at<BASE>(check.data(), check.size(), 0, num.data(), divLen);
+	check.resize(numLen);
+	CHECK(check == original);
+}
+
+// The divide and conquer conversion has to agree with plain repeated division
+// 4294967296 is the binary base 2^32
+TEMPLATE_TEST_CASE_SIG("Test digit_from_limbs matches repeated division in every base", "[digit_from_limbs]", ((std::uint64_t BASE), BASE),
+					   4294967296ULL, 1000000000, UINT32_MAX, 10, 2) {
+	auto len = GENERATE(1, 2, 23, 24, 25, 48, 49, 200, take(10, random(1, 400)));
+	std::uint32_t seed = len * 7;
+	std::minstd_rand rng{seed};
+	auto limbs = random_digits(rng, (std::uint64_t)1 << 32, len, seed % 5 == 0);
+	std::vector<std::uint32_t> expected(digit_from_limbs_bound<BASE>(len));
+	std::vector<std::uint32_t> result(digit_from_limbs_bound<BASE>(len));
+	expected.resize(digit_from_limbs_basecase<BASE>(expected.data(), limbs.data(), len));
+	result.resize(digit_from_limbs<BASE>(result.data(), limbs.data(), len));
+	INFO("base = " << BASE << " len = " << len);
+	CHECK(result == expected);
+	CHECK(expected.size() <= digit_from_limbs_bound<BASE>(len));
+	std::vector<std::uint32_t> zero(len, 0);
+	std::vector<std::uint32_t> out(digit_from_limbs_bound<BASE>(len));
+	CHECK(digit_from_limbs<BASE>(out.data(), zero.data(), len) == 0);
+}
+
+// digit_to_limbs has to undo digit_from_limbs
+// 4294967296 is the binary base 2^32
+TEMPLATE_TEST_CASE_SIG("Test digit_to_limbs undoes digit_from_limbs in every base", "[digit_to_limbs]", ((std::uint64_t BASE), BASE),
+					   4294967296ULL, 1000000000, UINT32_MAX, 10, 2) {
+	auto len = GENERATE(1, 2, 23, 24, 25, 48, 49, 200, take(10, random(1, 400)));
+	std::uint32_t seed = len * 3;
+	std::minstd_rand rng{seed};
+	auto digits = random_digits(rng, BASE, len, seed % 5 == 0);
+	std::vector<std::uint32_t> limbs(digit_to_limbs_bound<BASE>(len));
+	std::vector<std::uint32_t> expected(digit_to_limbs_bound<BASE>(len));
+	limbs.resize(digit_to_limbs<BASE>(limbs.data(), digits.data(), len));
+	expected.resize(digit_to_limbs_basecase<BASE>(expected.data(), digits.data(), len));
+	INFO("base = " << BASE << " len = " << len);
+	CHECK(limbs == expected);
+	std::vector<std::uint32_t> back(digit_from_limbs_bound<BASE>(limbs.size()));
+	back.resize(digit_from_limbs<BASE>(back.data(), limbs.data(), limbs.size()));
+	digits.resize(limb_active_length(digits.data(), digits.size()));
+	CHECK(back == digits);
+}
@@ -0,0 +1,53 @@
+#include "fixed_accumulator.h"
+#include "test_helpers.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <catch2/generators/catch_generators_adapters.hpp>
+#include <catch2/generators/catch_generators_all.hpp>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using TestFixed = FixedBigNum<6>;
+
+TEST_CASE("Test FixedAccumulator matches repeated +=", "[fixacc_add]") {
+	auto testVals = GENERATE(take(100, pair_random<std::int64_t>(INT64_MIN, INT64_MAX)));
+	std::minstd_rand rng{static_cast<std::uint32_t>(testVals.first)};
+	std::uniform_int_distribution<std::int64_t> dist{INT64_MIN + 1, INT64_MAX};
+	TestFixed expected{0};
+	FixedAccumulator<6> acc{};
+	for(std::size_t idx = 0; idx < 50; idx++) {
+		TestFixed lhs{dist(rng)};
+		TestFixed rhs{dist(rng)};
+		expected += lhs;
+		expected += lhs * rhs;
+		acc.add(lhs);
+		acc.addmul(lhs, rhs);
+	}
+	INFO("seed = " << testVals.first);
+	CHECK(acc.result() == expected);
+}
+
+TEST_CASE("Test parallel_accumulate matches a single accumulator", "[fixacc_parallel]") {
+	std::minstd_rand rng{42};
+	std::uniform_int_distribution<std::int64_t> dist{INT64_MIN + 1, INT64_MAX};
+	std::vector<TestFixed> lhs;
+	std::vector<TestFixed> rhs;
+	for(std::size_t idx = 0; idx < 1000; idx++) {
+		lhs.emplace_back(dist(rng));
+		rhs.emplace_back(dist(rng));
+	}
+
+	FixedAccumulator<6> serial{};
+	for(std::size_t idx = 0; idx < lhs.size(); idx++) {
+		serial.addmul(lhs[idx], rhs[idx]);
+	}
+
+	auto threads = GENERATE(1, 3, 8);
+	auto parallel = parallel_accumulate<6>(lhs.size(), threads, [&](FixedAccumulator<6>& acc, std::size_t idx) {
+		acc.addmul(lhs[idx], rhs[idx]);
+	});
+	INFO("threads = " << threads);
+	CHECK(parallel.result() == serial.result());
+}
@@ -0,0 +1,84 @@
+#include "fixed_base_pow.h"
+#include "test_helpers.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <catch2/generators/catch_generators_adapters.hpp>
+#include <catch2/generators/catch_generators_all.hpp>
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <vector>
+
+using TestType = FixedBigNum<8>;
+
+// base^exp mod mod with 128 bit intermediates
+static std::uint64_t reference_pow(std::uint64_t base, std::uint64_t exp, std::uint64_t mod) {
+	unsigned __int128 result = 1 % mod;
+	unsigned __int128 square = base % mod;
+	for(; exp != 0; exp >>= 1) {
+		if(exp & 1) {
+			result = (result * square) % mod;
+		}
+		square = (square * square) % mod;
+	}
+	return (std::uint64_t)result;
+}
+
+TEST_CASE("Test modpow and FixedBasePow match a 64 bit reference", "[fixpow_small]") {
+	auto testVals = GENERATE(take(200, pair_random<std::uint64_t>(0, UINT64_MAX)));
+	auto window = GENERATE(std::size_t{1}, std::size_t{3}, std::size_t{4}, std::size_t{7});
+	std::uint64_t mod = (testVals.first >> 1) | 1;
+	std::uint64_t base = testVals.second % mod;
+	FixedBasePow<8> table{TestType{base}, TestType{mod}, 64, window};
+	std::minstd_rand rng{static_cast<std::uint32_t>(testVals.second)};
+	INFO("base = " << base << " mod = " << mod << " window = " << window);
+	std::uint64_t mixed = ((std::uint64_t)rng() << 32) | rng();
+	for(std::uint64_t exp : {(std::uint64_t)0, (std::uint64_t)1, (std::uint64_t)2, (std::uint64_t)65537, mixed, (std::uint64_t)UINT64_MAX}) {
+		INFO("exp = " << exp);
+		CHECK(modpow(TestType{base}, TestType{exp}, TestType{mod}) == reference_pow(base, exp, mod));
+		CHECK(table.pow(TestType{exp}) == reference_pow(base, exp, mod));
+	}
+}
+
+TEST_CASE("Test FixedBasePow matches modpow on wide numbers", "[fixpow_wide]") {
+	auto seed = GENERATE(take(20, random<std::uint32_t>(0, UINT32_MAX)));
+	std::minstd_rand rng{seed};
+	std::vector<std::uint32_t> limbs(4);
+	for(auto& limb : limbs) {
+		limb = rng();
+	}
+	limbs.back() |= 0x80000000;
+	TestType mod{};
+	mod.import_limbs(limbs.data(), limbs.size());
+	TestType base = (TestType{rng()} * rng() * rng()) % mod;
+	FixedBasePow<8> table{base, mod, 100, 5};
+	INFO("seed = " << seed);
+	for(std::size_t idx = 0; idx < 10; idx++) {
+		// Some exponents run past the 100 bits the table covers
+		TestType exp = TestType{rng()} * rng() * rng() * rng() * rng();
+		CHECK(table.pow(exp) == modpow(base, exp, mod));
+	}
+}
+
+TEST_CASE("Test FixedBasePow can be shared between threads", "[fixpow_threads]") {
+	TestType mod = (TestType{1} << 200) - 75;
+	FixedBasePow<8> table{TestType{3}, mod, 200};
+	std::vector<TestType> expected;
+	for(std::uint64_t exp = 1; exp <= 64; exp++) {
+		expected.push_back(modpow(TestType{3}, TestType{exp * 0x9E3779B97F4A7C15ULL}, mod));
+	}
+	std::vector<int> matches(4, 0);
+	std::vector<std::thread> workers;
+	for(std::size_t thread = 0; thread < matches.size(); thread++) {
+		workers.emplace_back([&, thread]() {
+			for(std::uint64_t exp = 1; exp <= 64; exp++) {
+				matches[thread] += table.pow(TestType{exp * 0x9E3779B97F4A7C15ULL}) == expected[exp - 1];
+			}
+		});
+	}
+	for(auto& worker : workers) {
+		worker.join();
+	}
+	CHECK(matches == std::vector<int>(4, 64));
+}
@@ -1,10 +1,12 @@
 #include "fixed_bignum.h"
 #include "test_helpers.h"
 
+#include <catch2/catch_template_test_macros.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/generators/catch_generators.hpp>
 #include <catch2/generators/catch_generators_adapters.hpp>
 #include <catch2/generators/catch_generators_all.hpp>
+#include <bit>
 #include <compare>
 #include <cstdint>
 #include <string>
@@ -106,3 +108,213 @@ TEST_CASE("Check FixedBigNum modulo operator works as expected", "[fixbig_mod]")
 	CHECK(result == expected);
 }
 
+
+TEST_CASE("Check FixedBigNum converts to and from ArbitraryBigNum", "[fixbig_arbconv]") {
+	auto testVals = GENERATE(take(100, pair_random<std::int64_t>(INT64_MIN, INT64_MAX)));
+	std::int64_t a = testVals.first;
+	std::int64_t b = testVals.second;
+	FixedBigNum<4> tv1{a};
+	tv1 *= FixedBigNum<4>{b};
+
+	// The exact product fits in 128 bits, print it without going through a bignum
+	__int128 product = (__int128)a * b;
+	unsigned __int128 magnitude = (product < 0) ? -(unsigned __int128)product : (unsigned __int128)product;
+	std::string expected;
+	do {
+		expected.insert(expected.begin(), (char)('0' + (int)(magnitude % 10)));
+		magnitude /= 10;
+	} while(magnitude != 0);
+	if(product < 0) expected.insert(expected.begin(), '-');
+
+	ArbitraryBigNum binary{tv1};
+	ArbitraryBigNum<ARBITRARY_PRINTABLE> decimal{tv1};
+	std::stringstream viaFixed;
+	std::stringstream viaBinary;
+	std::stringstream viaDecimal;
+	viaFixed << tv1;
+	viaBinary << binary;
+	viaDecimal << decimal;
+	INFO("a = " << a << " b = " << b);
+	CHECK(expected == viaFixed.str());
+	CHECK(expected == viaBinary.str());
+	CHECK(expected == viaDecimal.str());
+
+	FixedBigNum<4> backFromBinary{binary};
+	FixedBigNum<4> backFromDecimal{decimal};
+	CHECK(backFromBinary == tv1);
+	CHECK(backFromDecimal == tv1);
+
+	// Truncates like the FixedBigNum to FixedBigNum conversion does
+	FixedBigNum<1> narrow{decimal};
+	CHECK(narrow == FixedBigNum<1>{tv1});
+}
+
+TEST_CASE("Check FixedBigNum bit queries work as expected", "[fixbig_bits]") {
+	auto testVals = GENERATE(take(1000, pair_random<std::uint64_t>(0U, UINT64_MAX)));
+	std::uint64_t a = GENERATE_COPY(testVals.first, 0);
+	std::size_t bit = testVals.second % 64;
+	TestFixed tv1{a};
+	INFO("a = " << a << " bit = " << bit);
+	CHECK(tv1.bit_width() == std::bit_width(a));
+	CHECK(tv1.popcount() == (std::size_t)std::popcount(a));
+	CHECK(tv1.countr_zero() == (std::size_t)std::countr_zero(a));
+	CHECK(tv1.test_bit(bit) == (((a >> bit) & 1) == 1));
+	CHECK(tv1.set_bit(bit) == (a | (1ULL << bit)));
+	CHECK(tv1.set_bit(bit, false) == (a & ~(1ULL << bit)));
+}
+
+TEST_CASE("Check wide FixedBigNum shifts keep every limb", "[fixbig_wideshift]") {
+	auto testVals = GENERATE(take(1000, pair_random<std::uint64_t>(0U, UINT64_MAX)));
+	std::uint64_t a = testVals.first;
+	std::size_t displacement = testVals.second % 192;
+	FixedBigNum<8> tv1{a};
+	auto shifted = tv1 << displacement;
+	INFO("a = " << a << " Offset = " << displacement);
+	CHECK(shifted.bit_width() == (a == 0 ? 0 : std::bit_width(a) + displacement));
+	CHECK(shifted.countr_zero() == (a == 0 ? 256 : std::countr_zero(a) + displacement));
+	CHECK((shifted >> displacement) == a);
+}
+
+TEST_CASE("Check FixedBigNum scalar operators match the general ones", "[fixbig_scalar]") {
+	auto testVals = GENERATE(take(1000, pair_random<std::int64_t>(INT64_MIN, INT64_MAX)));
+	std::int64_t a = testVals.first;
+	std::int64_t b = testVals.second;
+	std::int32_t small = static_cast<std::int32_t>(b);
+	FixedBigNum<4> tv1{a};
+	FixedBigNum<4> tv2{b};
+	FixedBigNum<4> tvSmall{small};
+	INFO("a = " << a << " b = " << b);
+	CHECK((tv1 + b) == (tv1 + tv2));
+	CHECK((tv1 - b) == (tv1 - tv2));
+	CHECK((tv1 * b) == (tv1 * tv2));
+	CHECK((tv1 * small) == (tv1 * tvSmall));
+	CHECK((tv1 * static_cast<std::uint64_t>(b)) == (tv1 * FixedBigNum<4>{static_cast<std::uint64_t>(b)}));
+	CHECK((tv1 <=> b) == (a <=> b));
+	CHECK((tv1 == a));
+	if(b != 0) {
+		CHECK((tv1 / b) == (a / b));
+		CHECK((tv1 % b) == (a % b));
+		CHECK((tv1 / tv2) == (a / b));
+		CHECK((tv1 % tv2) == (a % b));
+	}
+	if(small != 0) {
+		CHECK((tv1 / small) == (a / small));
+		CHECK((tv1 % small) == (a % small));
+		auto quotient = tv1;
+		std::uint64_t rem = quotient.divmod(small);
+		CHECK(quotient == (a / small));
+		CHECK(rem == static_cast<std::uint64_t>(std::abs(a % small)));
+	}
+}
+
+TEST_CASE("Check FixedBigNum limb import/export round trips", "[fixbig_limbio]") {
+	auto testVals = GENERATE(take(500, pair_random<std::int64_t>(INT64_MIN, INT64_MAX)));
+	// A small high word only reaches the third limb, a zero one leaves just b
+	std::uint64_t a = GENERATE_COPY(static_cast<std::uint64_t>(testVals.first), std::uint64_t{7}, std::uint64_t{0});
+	std::uint64_t b = static_cast<std::uint64_t>(testVals.second);
+	auto order = GENERATE(WordOrder::least_significant_first, WordOrder::most_significant_first);
+	auto endian = GENERATE(std::endian::little, std::endian::big);
+	// a * 2^64 + b
+	FixedBigNum<4> value{a};
+	value <<= 64;
+	value += b;
+	INFO("a = " << a << " b = " << b);
+
+	CHECK(value.limbs().size() == ((a >> 32) != 0 ? 4 : a != 0 ? 3 : (b >> 32) != 0 ? 2 : 1));
+	CHECK(value.limbs()[0] == (b & 0xFFFFFFFF));
+
+	std::uint64_t words[2];
+	value.export_limbs(words, 2, order, endian);
+	std::uint64_t low = (order == WordOrder::least_significant_first) ? words[0] : words[1];
+	CHECK((endian == std::endian::native ? low : word_byteswap(low)) == b);
+
+	std::uint8_t bytes[20];
+	value.export_limbs(bytes, 20, order, endian);
+	CHECK(FixedBigNum<4>{}.import_limbs(bytes, 20, order, endian) == value);
+	std::uint16_t halves[8];
+	value.export_limbs(halves, 8, order, endian);
+	CHECK(FixedBigNum<4>{}.import_limbs(halves, 8, order, endian) == value);
+	std::uint32_t limbs[4];
+	value.export_limbs(limbs, 4, order, endian);
+	CHECK(FixedBigNum<4>{}.import_limbs(limbs, 4, order, endian) == value);
+	CHECK(FixedBigNum<4>{}.import_limbs(words, 2, order, endian) == value);
+	// Exporting into too few words keeps the low end
+	value.export_limbs(words, 1, order, endian);
+	CHECK(FixedBigNum<4>{}.import_limbs(words, 1, order, endian) == FixedBigNum<4>{b});
+	CHECK(value.export_size<std::uint8_t>() == (value.bit_width() + 7) / 8);
+}
+
+TEST_CASE("Check FixedBigNum divexact matches division", "[fixbig_divexact]") {
+	auto testVals = GENERATE(take(1000, pair_random<std::int64_t>(INT64_MIN, INT64_MAX)));
+	FixedBigNum<8> a{testVals.first};
+	FixedBigNum<8> b{testVals.second};
+	a *= a;
+	b *= 3;
+	INFO("a = " << testVals.first << " b = " << testVals.second);
+	CHECK((a * b).divexact(b) == a);
+	CHECK((a * b).divexact(a) == b);
+	CHECK((a * b * 2).divexact(FixedBigNum<8>{-6}) == ((a * b * 2) / -6));
+}
+
+// The unrolled widths against FixedBigNum<40>, which takes the looped paths, truncated back down
+TEMPLATE_TEST_CASE_SIG("Check unrolled small widths match the general loops", "[fixbig_unrolled]", ((std::size_t U), U), 3, 4, 8, 16, 32) {
+	using Wide = FixedBigNum<40>;
+	auto testVals = GENERATE(take(200, pair_random<std::int64_t>(INT64_MIN, INT64_MAX)));
+	std::int64_t a = testVals.first;
+	std::int64_t b = testVals.second;
+	for(std::size_t limbs : {1, 2, 3, 4, 8, 16, 32}) {
+		Wide lhs{a};
+		Wide rhs{b};
+		// Spread the pair over roughly the requested number of limbs
+		for(std::size_t idx = 2; idx < limbs; idx += 2) {
+			lhs = (lhs << 64) + (a ^ (std::int64_t)idx);
+			rhs = (rhs << 64) + (b + (std::int64_t)idx);
+		}
+		FixedBigNum<U> small{lhs};
+		FixedBigNum<U> other{rhs};
+		lhs = Wide{small};
+		rhs = Wide{other};
+		INFO("U = " << U << " a = " << a << " b = " << b << " limbs = " << limbs);
+		CHECK((small + other) == FixedBigNum<U>{lhs + rhs});
+		CHECK((small - other) == FixedBigNum<U>{lhs - rhs});
+		CHECK((other - small) == FixedBigNum<U>{rhs - lhs});
+		CHECK((small * other) == FixedBigNum<U>{lhs * rhs});
+		CHECK((small - small) == FixedBigNum<U>{0});
+		CHECK((small <=> other) == (lhs <=> rhs));
+	}
+}
+
+TEST_CASE("Check unrolled small widths work in constant expressions", "[fixbig_unrolled_constexpr]") {
+	constexpr auto product = []() {
+		FixedBigNum<4> value{0xFFFFFFFFFFFFFFFFULL};
+		value *= value;
+		value -= FixedBigNum<4>{1};
+		return value + FixedBigNum<4>{2};
+	}();
+	STATIC_REQUIRE(product.bit_width() == 128);
+	STATIC_REQUIRE(product.test_bit(65));
+	STATIC_REQUIRE(product.popcount() == 64);
+}
+
+TEST_CASE("Check FixedBigNum mul_high is the shifted product or one below", "[fixbig_mulhigh]") {
+	auto testVals = GENERATE(take(300, pair_random<std::int64_t>(INT64_MIN, INT64_MAX)));
+	using Wide = FixedBigNum<160>;
+	FixedBigNum<80> a{testVals.first};
+	FixedBigNum<80> b{testVals.second};
+	// Grow both to a mix of odd and even active lengths, past limb_mul_high_limbs on the last rounds
+	std::size_t rounds = GENERATE(10, 19, 20);
+	for(std::size_t idx = 0; idx < rounds; idx++) {
+		a = (a << 61) + testVals.second;
+		b = (b << ((idx % 2) ? 64 : 32)) - testVals.first;
+	}
+	std::size_t total = a.limbs().size() + b.limbs().size();
+	for(std::size_t k : {std::size_t{1}, std::size_t{7}, total / 2, std::size_t{80}}) {
+		auto high = mul_high(a, b, k);
+		Wide expected = (Wide{a} * Wide{b}) >> (32 * (total - std::min(k, total)));
+		INFO("a = " << a << " b = " << b << " k = " << k);
+		// The top limbs can be zero when the product is a limb short
+		CHECK(((high == FixedBigNum<80>{0}) || (signbit(high) == signbit(expected))));
+		auto diff = abs(Wide{expected}) - abs(Wide{high});
+		CHECK(((diff == Wide{0}) || (diff == Wide{1})));
+	}
+}
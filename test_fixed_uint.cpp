@@ -0,0 +1,66 @@
+#include "fixed_uint.h"
+#include "test_helpers.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <catch2/generators/catch_generators_adapters.hpp>
+#include <catch2/generators/catch_generators_all.hpp>
+#include <compare>
+#include <cstdint>
+#include <sstream>
+#include <string>
+
+using TestUInt = FixedUInt<2>;
+
+TEST_CASE("Test FixedUInt wraps like a uint64", "[fixuint_wrap]") {
+	auto testVals = GENERATE(take(1000, pair_random<std::uint64_t>(0U, UINT64_MAX)));
+	std::uint64_t a = testVals.first;
+	std::uint64_t b = testVals.second;
+	TestUInt tv1{a};
+	TestUInt tv2{b};
+	INFO("a = " << a << " b = " << b);
+	CHECK((tv1 + tv2) == TestUInt{a + b});
+	CHECK((tv1 - tv2) == TestUInt{a - b});
+	CHECK((tv1 * tv2) == TestUInt{a * b});
+	CHECK(-tv1 == TestUInt{0 - a});
+	CHECK((tv1 <=> tv2) == (a <=> b));
+}
+
+TEST_CASE("Test FixedUInt shifts and bitwise operators", "[fixuint_bits]") {
+	auto testVals = GENERATE(take(1000, pair_random<std::uint64_t>(0U, UINT64_MAX)));
+	std::uint64_t a = testVals.first;
+	std::uint64_t b = testVals.second;
+	std::size_t displacement = b % 64;
+	TestUInt tv1{a};
+	TestUInt tv2{b};
+	INFO("a = " << a << " b = " << b);
+	CHECK((tv1 << displacement) == TestUInt{a << displacement});
+	CHECK((tv1 >> displacement) == TestUInt{a >> displacement});
+	CHECK((tv1 & tv2) == TestUInt{a & b});
+	CHECK((tv1 | tv2) == TestUInt{a | b});
+	CHECK((tv1 ^ tv2) == TestUInt{a ^ b});
+	CHECK(~tv1 == TestUInt{~a});
+}
+
+TEST_CASE("Test FixedUInt converts to and from FixedBigNum", "[fixuint_conv]") {
+	auto testVals = GENERATE(take(100, pair_random<std::int64_t>(INT64_MIN, INT64_MAX)));
+	std::int64_t a = testVals.first;
+	std::int64_t b = testVals.second;
+	FixedBigNum<4> signedVal{a};
+	signedVal *= FixedBigNum<4>{b};
+	FixedUInt<4> wrapped{signedVal};
+	INFO("a = " << a << " b = " << b);
+	// Adding the magnitude back onto a negative number wraps around to 0
+	if(signbit(signedVal)) {
+		CHECK((wrapped + FixedUInt<4>{abs(signedVal)}) == FixedUInt<4>{0U});
+	} else {
+		CHECK(static_cast<FixedBigNum<4>>(wrapped) == signedVal);
+	}
+	CHECK(FixedUInt<4>{a} == FixedUInt<4>{FixedBigNum<4>{a}});
+
+	std::stringstream expected;
+	std::stringstream result;
+	expected << static_cast<std::uint64_t>(a);
+	result << TestUInt{a};
+	CHECK(expected.str() == result.str());
+}
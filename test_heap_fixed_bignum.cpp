@@ -0,0 +1,113 @@
+#include "heap_fixed_bignum.h"
+#include "test_helpers.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <catch2/generators/catch_generators_adapters.hpp>
+#include <catch2/generators/catch_generators_all.hpp>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <utility>
+
+using TestHeap = HeapFixedBigNum<6>;
+using TestFixed = FixedBigNum<6>;
+
+TEST_CASE("Test HeapFixedBigNum matches FixedBigNum", "[heapfix_arith]") {
+	auto testVals = GENERATE(take(1000, pair_random<std::int64_t>(INT64_MIN, INT64_MAX)));
+	std::int64_t a = testVals.first;
+	std::int64_t b = testVals.second;
+	TestHeap tv1{a};
+	TestHeap tv2{b};
+	TestFixed fv1{a};
+	TestFixed fv2{b};
+	INFO("a = " << a << " b = " << b);
+	CHECK(static_cast<TestFixed>(tv1 + tv2) == (fv1 + fv2));
+	CHECK(static_cast<TestFixed>(tv1 - tv2) == (fv1 - fv2));
+	CHECK(static_cast<TestFixed>(tv1 * tv2) == (fv1 * fv2));
+	CHECK(static_cast<TestFixed>(tv1 * tv2 * tv2) == (fv1 * fv2 * fv2));
+	CHECK((tv1 <=> tv2) == (a <=> b));
+	CHECK(TestHeap{fv1 * fv2} == (tv1 * tv2));
+
+	std::stringstream expected;
+	std::stringstream result;
+	expected << (fv1 * fv2);
+	result << (tv1 * tv2);
+	CHECK(expected.str() == result.str());
+}
+
+TEST_CASE("Test HeapFixedBigNum scalar add and zeroing match FixedBigNum", "[heapfix_scalar]") {
+	auto testVals = GENERATE(take(1000, pair_random<std::int64_t>(INT64_MIN, INT64_MAX)));
+	std::uint32_t add = static_cast<std::uint32_t>(testVals.second);
+	INFO("a = " << testVals.first << " add = " << add);
+	// Wide values, small values and ones that cross zero
+	for(std::int64_t a : {testVals.first, testVals.first % 1000, -(std::int64_t)(add / 2), -(std::int64_t)add}) {
+		TestHeap tv1{a};
+		TestFixed fv1{a};
+		tv1 *= tv1;
+		fv1 *= fv1;
+		if(a < 0) {
+			tv1 *= TestHeap{-1};
+			fv1 *= TestFixed{-1};
+		}
+		CHECK(static_cast<TestFixed>(tv1) == fv1);
+		// The general add is the reference
+		auto expected = tv1 + TestHeap{add};
+		tv1 += add;
+		CHECK(tv1 == expected);
+		TestHeap tv2{a};
+		tv2 += add;
+		CHECK(tv2 == (TestHeap{a} + TestHeap{add}));
+	}
+
+	// Zeroing only clears the limbs in use, later results can't see stale ones
+	TestHeap big{testVals.first};
+	big *= big;
+	big *= big;
+	TestHeap zero{big};
+	zero *= TestHeap{0};
+	CHECK(zero == TestHeap{0});
+	zero += add;
+	CHECK(zero == TestHeap{add});
+	zero -= zero;
+	CHECK(zero == TestHeap{0});
+	CHECK(!signbit(zero));
+	zero = big;
+	CHECK(zero.divmod(0) == 0);
+	CHECK(zero == TestHeap{0});
+	zero += big;
+	CHECK(zero == big);
+}
+
+TEST_CASE("Test HeapFixedBigNum moves hand over the buffer", "[heapfix_move]") {
+	TestHeap a{12345};
+	TestHeap b{std::move(a)};
+	CHECK(b == TestHeap{12345});
+	a = TestHeap{-7};
+	a = std::move(b);
+	CHECK(a == TestHeap{12345});
+
+	// A moved-from number can be copied into as well
+	TestHeap c{std::move(a)};
+	TestHeap d{-98765};
+	a = d;
+	CHECK(a == TestHeap{-98765});
+	CHECK(c == TestHeap{12345});
+	a += c;
+	CHECK(a == TestHeap{12345 - 98765});
+}
+
+TEST_CASE("Test HeapFixedBigNum handles widths that would not fit on the stack", "[heapfix_wide]") {
+	// 2^21 limbs is 8MB, a FixedBigNum this wide would blow the default stack
+	using Huge = HeapFixedBigNum<(1 << 21)>;
+	Huge value{3};
+	for(std::size_t idx = 0; idx < 12; idx++) {
+		value *= value;
+	}
+	// 3^4096
+	CHECK(value.bit_width() == 6493);
+	Huge other{value};
+	other -= value;
+	CHECK(other == Huge{0});
+	CHECK(value.divmod(3) == 0);
+}
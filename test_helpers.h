@@ -14,6 +14,9 @@
 
 #include <utility>
 
+#include <cstddef>
+#include <cstdint>
+
 template<typename T>
 class RandomPairGenerator : public Catch::Generators::IGenerator<std::pair<T, T>> {
 	std::minstd_rand m_rand;
@@ -45,6 +48,27 @@ Catch::Generators::GeneratorWrapper<std::pair<T, T>> pair_random(T low, T high)
 	);
 }
 
+// seed squared rounds times with add added after each square, so the number of
+// digits roughly doubles every round. Num is any ArbitraryBigNum
+template<typename Num>
+Num grown_number(std::int64_t seed, std::int64_t add, std::size_t rounds) {
+	Num val{seed};
+	for(std::size_t idx = 0; idx < rounds; idx++) {
+		val = val * val + add;
+	}
+	return val;
+}
+
+// Two unrelated large operands from x and y. The first is grown_number(x, y, rounds),
+// about 64 * 2^rounds bits. The second is a number of the same size times the first
+// shifted right by shift bits, so about 2 * 64 * 2^rounds - shift bits
+template<typename Num>
+std::pair<Num, Num> grown_operands(std::int64_t x, std::int64_t y, std::size_t rounds, std::size_t shift) {
+	auto lhs = grown_number<Num>(x, y, rounds);
+	auto rhs = grown_number<Num>(y, -x, rounds) * (lhs >> shift);
+	return {lhs, rhs};
+}
+
 inline constexpr std::string_view comparisonString(std::partial_ordering x) {
 	if (x == std::partial_ordering::less)
 		return "Less than";
@@ -0,0 +1,219 @@
+#include "limb_kernels.h"
+#include "test_helpers.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <catch2/generators/catch_generators_adapters.hpp>
+#include <catch2/generators/catch_generators_all.hpp>
+#include <array>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+// Plain 32 bit schoolbook multiplication to check the fast kernels against
+static std::vector<std::uint32_t> reference_mul(std::vector<std::uint32_t> const& lhs, std::vector<std::uint32_t> const& rhs) {
+	std::vector<std::uint32_t> res(lhs.size() + rhs.size(), 0);
+	for(std::size_t idx = 0; idx < rhs.size(); idx++) {
+		std::uint64_t carry = 0;
+		for(std::size_t idy = 0; idy < lhs.size(); idy++) {
+			carry += ((std::uint64_t)lhs[idy] * rhs[idx]) + res[idx + idy];
+			res[idx + idy] = carry & 0xFFFFFFFF;
+			carry >>= 32;
+		}
+		res[idx + lhs.size()] = carry & 0xFFFFFFFF;
+	}
+	return res;
+}
+
+static std::vector<std::uint32_t> random_limbs(std::minstd_rand& rng, std::size_t len, bool saturated) {
+	std::uniform_int_distribution<std::uint32_t> dist{0, UINT32_MAX};
+	std::vector<std::uint32_t> limbs(len);
+	for(auto& limb : limbs) {
+		limb = saturated ? UINT32_MAX : dist(rng);
+	}
+	return limbs;
+}
+
+TEST_CASE("Test limb_mul_basecase matches schoolbook multiplication", "[limb_mul]") {
+	auto testVals = GENERATE(take(200, pair_random<std::uint32_t>(1U, 40U)));
+	std::minstd_rand rng{testVals.first * 131 + testVals.second};
+	// All-ones inputs push every carry chain to its limit
+	bool saturated = GENERATE(false, true);
+	auto lhs = random_limbs(rng, testVals.first, saturated);
+	auto rhs = random_limbs(rng, testVals.second, saturated);
+	std::vector<std::uint32_t> result(lhs.size() + rhs.size(), 0xDEADBEEF);
+	limb_mul_basecase(result.data(), lhs.data(), lhs.size(), rhs.data(), rhs.size());
+	INFO("lhs limbs = " << lhs.size() << " rhs limbs = " << rhs.size());
+	CHECK(result == reference_mul(lhs, rhs));
+}
+
+TEST_CASE("Test limb_mul_basecase works in constant expressions", "[limb_mul_constexpr]") {
+	constexpr auto product = []() {
+		std::uint32_t lhs[3] = {UINT32_MAX, UINT32_MAX, 7};
+		std::uint32_t rhs[2] = {UINT32_MAX, 3};
+		std::array<std::uint32_t, 5> res{};
+		limb_mul_basecase(res.data(), lhs, 3, rhs, 2);
+		return res;
+	}();
+	std::vector<std::uint32_t> expected = reference_mul({UINT32_MAX, UINT32_MAX, 7}, {UINT32_MAX, 3});
+	CHECK(std::vector<std::uint32_t>(product.begin(), product.end()) == expected);
+}
+
+#ifdef LIMB_KERNELS_WORDS
+TEST_CASE("Test word_addmul_1 matches limb_addmul_1", "[limb_addmul]") {
+	auto testVals = GENERATE(take(200, pair_random<std::uint32_t>(1U, 32U)));
+	std::minstd_rand rng{testVals.first * 7 + testVals.second};
+	auto data = random_limbs(rng, 2 * testVals.first, false);
+	auto start = random_limbs(rng, 2 * testVals.first, false);
+	auto mult = random_limbs(rng, 2, false);
+
+	// res += data * (hi:lo) as two 32 bit passes
+	auto expected = start;
+	expected.resize(expected.size() + 2, 0);
+	expected[data.size()] = limb_addmul_1(expected.data(), data.data(), data.size(), mult[0]);
+	limb_add_1(expected.data() + data.size() + 1, 1, limb_addmul_1(expected.data() + 1, data.data(), data.size(), mult[1]));
+
+	auto result = start;
+	std::uint64_t carry = word_addmul_1(result.data(), data.data(), testVals.first, word_load(mult.data(), 0));
+	result.push_back(carry & 0xFFFFFFFF);
+	result.push_back(carry >> 32);
+	CHECK(result == expected);
+}
+
+TEST_CASE("Test word_addmul_4x4 matches schoolbook multiplication", "[limb_addmul_4x4]") {
+	auto seed = GENERATE(take(500, random<std::uint32_t>(0U, UINT32_MAX)));
+	std::minstd_rand rng{seed};
+	// All-ones inputs and accumulators carry out of every word
+	bool saturated = GENERATE(false, true);
+	auto lhs = random_limbs(rng, 8, saturated);
+	auto rhs = random_limbs(rng, 8, saturated);
+	auto start = random_limbs(rng, 16, saturated);
+
+	auto expected = reference_mul(lhs, rhs);
+	expected.push_back(0);
+	std::uint64_t sum = 0;
+	for(std::size_t idx = 0; idx < expected.size(); idx++) {
+		sum += (std::uint64_t)expected[idx] + ((idx < start.size()) ? start[idx] : 0);
+		expected[idx] = sum & 0xFFFFFFFF;
+		sum >>= 32;
+	}
+
+	auto result = start;
+	std::uint64_t carry = word_addmul_4x4(result.data(), lhs.data(), rhs.data());
+	result.push_back(carry & 0xFFFFFFFF);
+	INFO("seed = " << seed);
+	CHECK(carry <= 1);
+	CHECK(result == expected);
+}
+#endif
+
+TEST_CASE("Test limb_divexact undoes multiplication", "[limb_divexact]") {
+	auto testVals = GENERATE(take(300, pair_random<std::uint32_t>(1U, 30U)));
+	std::minstd_rand rng{testVals.first * 977 + testVals.second};
+	bool saturated = GENERATE(false, true);
+	auto quotient = random_limbs(rng, testVals.first, saturated);
+	auto divisor = random_limbs(rng, testVals.second, saturated);
+	quotient.back() |= 1;
+	divisor.back() |= 1;
+	// Even divisors take the power of two shifting path
+	std::size_t shift = rng() % 3;
+	if(shift != 0) {
+		divisor.insert(divisor.begin(), shift - 1, 0);
+		divisor[shift - 1] = 1U << (rng() % 32);
+	}
+	auto product = reference_mul(quotient, divisor);
+	std::vector<std::uint32_t> result(product.size(), 0xDEADBEEF);
+	auto len = limb_divexact(result.data(), product.data(), product.size(), divisor.data(), divisor.size());
+	INFO("quotient limbs = " << quotient.size() << " divisor limbs = " << divisor.size());
+	REQUIRE(len >= quotient.size());
+	result.resize(len);
+	quotient.resize(len, 0);
+	CHECK(result == quotient);
+}
+
+TEST_CASE("Test limb_divmod_n inverts multiplication", "[limb_divmod]") {
+	auto testVals = GENERATE(take(300, pair_random<std::uint32_t>(1U, 30U)));
+	std::minstd_rand rng{testVals.first * 3571 + testVals.second};
+	bool saturated = GENERATE(false, true);
+	auto quotient = random_limbs(rng, testVals.first, saturated);
+	auto divisor = random_limbs(rng, testVals.second, saturated);
+	divisor.back() |= 1;
+	// A remainder below the divisor
+	auto remainder = divisor;
+	remainder.back() >>= 1;
+	auto num = reference_mul(quotient, divisor);
+	auto carry = limb_add_n(num.data(), num.data(), remainder.data(), remainder.size());
+	limb_add_1(num.data() + remainder.size(), num.size() - remainder.size(), carry);
+	auto div = divisor;
+	std::vector<std::uint32_t> quot(num.size() - divisor.size() + 1);
+	num.push_back(0);
+	limb_divmod_n(quot.data(), num.data(), num.size() - 1, div.data(), div.size());
+	INFO("quotient limbs = " << quotient.size() << " divisor limbs = " << divisor.size());
+	CHECK(div == divisor);
+	quotient.resize(quot.size(), 0);
+	CHECK(quot == quotient);
+	CHECK(std::vector<std::uint32_t>(num.begin(), num.begin() + divisor.size()) == remainder);
+}
+
+TEST_CASE("Test limb_clmul_n matches the carry-less basecase", "[limb_clmul]") {
+	auto testVals = GENERATE(take(200, pair_random<std::uint32_t>(1U, 70U)));
+	std::minstd_rand rng{testVals.first * 7919 + testVals.second};
+	bool saturated = GENERATE(false, true);
+	auto lhs = random_limbs(rng, testVals.first, saturated);
+	auto rhs = random_limbs(rng, testVals.first, saturated);
+	std::size_t n = lhs.size();
+	std::vector<std::uint32_t> expected(2 * n);
+	std::vector<std::uint32_t> result(2 * n);
+	std::vector<std::uint32_t> scratch(limb_clmul_scratch(n));
+	// 32 bit carry-less schoolbook as the reference
+	for(std::size_t row = 0; row < n; row++) {
+		for(std::size_t col = 0; col < n; col++) {
+			auto prod = limb_clmul_1(lhs[col], rhs[row]);
+			expected[row + col] ^= (std::uint32_t)prod;
+			expected[row + col + 1] ^= (std::uint32_t)(prod >> 32);
+		}
+	}
+	limb_clmul_n(result.data(), lhs.data(), rhs.data(), n, scratch.data());
+	CHECK(result == expected);
+	limb_clsquare(result.data(), lhs.data(), n);
+	limb_clmul_basecase(expected.data(), lhs.data(), n, lhs.data(), n);
+	CHECK(result == expected);
+}
+
+TEST_CASE("Test carry-less kernels work in constant expressions", "[limb_clmul_constexpr]") {
+	constexpr auto product = []() {
+		std::array<std::uint32_t, 2> lhs{0xFFFFFFFF, 0x1};
+		std::array<std::uint32_t, 2> rhs{0x3, 0};
+		std::array<std::uint32_t, 4> res{};
+		limb_clmul_basecase(res.data(), lhs.data(), 2, rhs.data(), 2);
+		return res;
+	}();
+	// (x^32 + x^31 + ... + 1)(x + 1) = x^33 + 1
+	STATIC_REQUIRE(product[0] == 0x1);
+	STATIC_REQUIRE(product[1] == 0x2);
+	STATIC_REQUIRE(product[2] == 0);
+	STATIC_REQUIRE(limb_clmul_1(0x80000001, 0x80000001) == 0x4000000000000001ULL);
+}
+
+TEST_CASE("Test limb_mul_high is the top of the full product or one below", "[limb_mul_high]") {
+	auto testVals = GENERATE(take(300, pair_random<std::uint32_t>(1U, 40U)));
+	std::minstd_rand rng{testVals.first * 104729 + testVals.second};
+	bool saturated = GENERATE(false, true);
+	auto lhs = random_limbs(rng, testVals.first, saturated);
+	auto rhs = random_limbs(rng, testVals.second, saturated);
+	auto full = reference_mul(lhs, rhs);
+	std::size_t total = lhs.size() + rhs.size();
+	for(std::size_t k : {std::size_t{1}, total / 2, total - 1, total, total + 3}) {
+		std::size_t kept = std::min(k, total);
+		std::vector<std::uint32_t> high(k + 10);
+		auto at = limb_mul_high(high.data(), lhs.data(), lhs.size(), rhs.data(), rhs.size(), k);
+		std::vector<std::uint32_t> result(high.begin() + at, high.begin() + at + kept);
+		std::vector<std::uint32_t> expected(full.end() - kept, full.end());
+		INFO("lhs limbs = " << lhs.size() << " rhs limbs = " << rhs.size() << " k = " << k);
+		if(result != expected) {
+			// Only ever one below
+			limb_add_1(result.data(), result.size(), 1);
+		}
+		CHECK(result == expected);
+	}
+}
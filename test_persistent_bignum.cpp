@@ -0,0 +1,109 @@
+#include "persistent_bignum.h"
+#include "test_helpers.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <catch2/generators/catch_generators_adapters.hpp>
+#include <catch2/generators/catch_generators_all.hpp>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+// Several hundred digits so the values go well past the ColdVector buffer
+template<std::size_t MAX_VAL>
+static ArbitraryBigNum<MAX_VAL, ColdLimbs> big_value(std::int64_t seed, std::int64_t add) {
+	return ArbitraryBigNum<MAX_VAL, ColdLimbs>{grown_number<ArbitraryBigNum<>>(seed, add, 8)};
+}
+
+TEST_CASE("Test PersistentBigNum survives a checkpoint and open", "[persist_roundtrip]") {
+	auto testVals = GENERATE(take(5, pair_random<std::int64_t>(INT64_MIN + 1, INT64_MAX)));
+	std::string name = "persist_roundtrip.abn";
+	{
+		PersistentBigNum<> num{name, big_value<UINT32_MAX>(testVals.first, testVals.second)};
+		REQUIRE(num.checkpoint());
+	}
+	CHECK(PersistentBigNum<>::verify(name));
+	auto resumed = PersistentBigNum<>::open(name);
+	CHECK(resumed.name() == name);
+	CHECK(resumed.value() == big_value<UINT32_MAX>(testVals.first, testVals.second));
+
+	// Writing to the resumed value leaves the checkpoint alone until the next one
+	resumed.value() += 1;
+	resumed.value() *= resumed.value();
+	auto expected = big_value<UINT32_MAX>(testVals.first, testVals.second) + 1;
+	expected *= expected;
+	CHECK(resumed.value() == expected);
+	CHECK(PersistentBigNum<>::open(name).value() == big_value<UINT32_MAX>(testVals.first, testVals.second));
+	REQUIRE(resumed.checkpoint());
+	CHECK(PersistentBigNum<>::verify(name));
+	CHECK(PersistentBigNum<>::open(name).value() == expected);
+
+	// Decimal digits and signs go through as well
+	std::string decimalName = "persist_roundtrip_decimal.abn";
+	auto negative = ArbitraryBigNum<ARBITRARY_PRINTABLE, ColdLimbs>{0} - big_value<ARBITRARY_PRINTABLE>(testVals.second, testVals.first);
+	REQUIRE(PersistentBigNum<ARBITRARY_PRINTABLE>{decimalName, negative}.checkpoint());
+	CHECK(PersistentBigNum<ARBITRARY_PRINTABLE>::open(decimalName).value() == negative);
+	CHECK_THROWS_AS(PersistentBigNum<>::open(decimalName), std::runtime_error);
+	std::remove(name.c_str());
+	std::remove(decimalName.c_str());
+}
+
+TEST_CASE("Test PersistentBigNum open leaves the checkpoint in place", "[persist_readonly]") {
+	std::string name = "persist_readonly.abn";
+	REQUIRE(PersistentBigNum<>{name, big_value<UINT32_MAX>(987654321, 42)}.checkpoint());
+	{
+		auto resumed = PersistentBigNum<>::open(name);
+		CHECK(resumed.value() == big_value<UINT32_MAX>(987654321, 42));
+	}
+	CHECK(std::filesystem::exists(name));
+	CHECK(PersistentBigNum<>::verify(name));
+	CHECK(PersistentBigNum<>::open(name).value() == big_value<UINT32_MAX>(987654321, 42));
+	CHECK(std::filesystem::exists(name));
+	std::remove(name.c_str());
+}
+
+TEST_CASE("Test PersistentBigNum refuses broken checkpoints", "[persist_broken]") {
+	std::string name = "persist_broken.abn";
+	CHECK_THROWS_AS(PersistentBigNum<>::open(name), std::runtime_error);
+	CHECK(!PersistentBigNum<>::verify(name));
+	REQUIRE(PersistentBigNum<>{name, big_value<UINT32_MAX>(12345, 678)}.checkpoint());
+
+	// A flipped digit fails the checksum
+	{
+		std::fstream file{name, std::ios::in | std::ios::out | std::ios::binary};
+		file.seekp(40 + 100, std::ios::beg);
+		file.put(0x5A);
+	}
+	CHECK(!PersistentBigNum<>::verify(name));
+
+	// A missing tail can't be opened
+	std::filesystem::resize_file(name, 40 + 8);
+	CHECK(!PersistentBigNum<>::verify(name));
+	CHECK_THROWS_AS(PersistentBigNum<>::open(name), std::runtime_error);
+
+	// A zero top digit is refused when opening, without needing verify()
+	REQUIRE(PersistentBigNum<>{name, big_value<UINT32_MAX>(12345, 678)}.checkpoint());
+	{
+		std::fstream file{name, std::ios::in | std::ios::out | std::ios::binary};
+		file.seekp(std::filesystem::file_size(name) - sizeof(std::uint32_t), std::ios::beg);
+		std::uint32_t zero = 0;
+		file.write(reinterpret_cast<char const*>(&zero), sizeof(zero));
+	}
+	CHECK_THROWS_AS(PersistentBigNum<>::open(name), std::runtime_error);
+
+	// Zero itself is a single zero digit and opens fine
+	REQUIRE(PersistentBigNum<>{name, ArbitraryBigNum<UINT32_MAX, ColdLimbs>{0}}.checkpoint());
+	CHECK(PersistentBigNum<>::verify(name));
+	CHECK(PersistentBigNum<>::open(name).value() == 0);
+
+	// Something that isn't a checkpoint can't be opened either
+	{
+		std::ofstream file{name, std::ios::out | std::ios::trunc};
+		file << "12345678901234567890123456789012345678901234567890";
+	}
+	CHECK_THROWS_AS(PersistentBigNum<>::open(name), std::runtime_error);
+	std::remove(name.c_str());
+}
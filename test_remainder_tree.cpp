@@ -0,0 +1,67 @@
+#include "remainder_tree.h"
+#include "test_helpers.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <catch2/generators/catch_generators_adapters.hpp>
+#include <catch2/generators/catch_generators_all.hpp>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using TestType = FixedBigNum<64>;
+
+static std::vector<std::uint32_t> reference_mods(TestType const& num, std::vector<std::uint32_t> const& moduli) {
+	std::vector<std::uint32_t> result;
+	for(auto mod : moduli) {
+		TestType temp{num};
+		result.push_back(temp.divmod(mod));
+	}
+	return result;
+}
+
+static std::vector<std::uint32_t> random_moduli(std::minstd_rand& rng, std::size_t count) {
+	std::uniform_int_distribution<std::uint32_t> dist{1, UINT32_MAX};
+	std::vector<std::uint32_t> moduli(count);
+	for(auto& mod : moduli) {
+		mod = dist(rng);
+	}
+	// The edges of the range
+	moduli[0] = 1;
+	moduli[count / 2] = UINT32_MAX;
+	moduli[count - 1] = 2;
+	return moduli;
+}
+
+TEST_CASE("Test mod_u32_many and RemainderTree match divmod", "[remtree_reduce]") {
+	auto testVals = GENERATE(take(40, pair_random<std::uint32_t>(1U, 64U)));
+	std::minstd_rand rng{testVals.first * 7919 + testVals.second};
+	std::uniform_int_distribution<std::uint32_t> dist{0, UINT32_MAX};
+	std::vector<std::uint32_t> limbs(testVals.first);
+	for(auto& limb : limbs) {
+		limb = dist(rng);
+	}
+	TestType num{};
+	num.import_limbs(limbs.data(), limbs.size());
+	auto moduli = random_moduli(rng, testVals.second * 11);
+	auto expected = reference_mods(num, moduli);
+	INFO("limbs = " << limbs.size() << " moduli = " << moduli.size());
+
+	CHECK(mod_u32_many(num, moduli) == expected);
+	RemainderTree tree{moduli};
+	CHECK(tree.reduce(num) == expected);
+	CHECK(tree.reduce(TestType{0}) == std::vector<std::uint32_t>(moduli.size(), 0));
+}
+
+TEST_CASE("Test RemainderTree product is the product of the moduli", "[remtree_product]") {
+	std::vector<std::uint32_t> moduli;
+	TestType expected{1};
+	for(std::uint32_t idx = 0; idx < 150; idx++) {
+		moduli.push_back(4000000007U - (idx * 2));
+		expected *= moduli.back();
+	}
+	RemainderTree tree{moduli};
+	TestType product{};
+	product.import_limbs(tree.product().data(), tree.product().size());
+	CHECK(product == expected);
+}
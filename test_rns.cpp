@@ -0,0 +1,78 @@
+#include "rns.h"
+#include "test_helpers.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <catch2/generators/catch_generators_adapters.hpp>
+#include <catch2/generators/catch_generators_all.hpp>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using TestFixed = FixedBigNum<12>;
+
+TEST_CASE("Test RnsBasis picks distinct primes above 2^30", "[rns_basis]") {
+	auto const& basis = RnsBasis<20>::get();
+	CHECK(basis.primes[0] == 2147483647U);
+	for(std::size_t idx = 1; idx < 20; idx++) {
+		CHECK(basis.primes[idx] < basis.primes[idx - 1]);
+		CHECK(basis.primes[idx] > (1U << 30));
+	}
+}
+
+TEST_CASE("Test RnsNum arithmetic matches FixedBigNum", "[rns_arith]") {
+	auto testVals = GENERATE(take(500, pair_random<std::int64_t>(INT64_MIN, INT64_MAX)));
+	std::int64_t a = testVals.first;
+	std::int64_t b = testVals.second;
+	TestFixed fa{a};
+	TestFixed fb{b};
+	// 11 lanes gets eight lanes through the vector path plus a scalar tail
+	RnsNum<11> ra{fa};
+	RnsNum<11> rb{fb};
+	INFO("a = " << a << " b = " << b);
+	CHECK((ra + rb) == RnsNum<11>{fa + fb});
+	CHECK((ra - rb) == RnsNum<11>{fa - fb});
+	CHECK((ra * rb) == RnsNum<11>{fa * fb});
+	CHECK((ra * rb * rb) == RnsNum<11>{fa * fb * fb});
+	CHECK(static_cast<TestFixed>(ra * ra * rb * rb) == (fa * fa * fb * fb));
+	if(a >= 0) {
+		CHECK(static_cast<TestFixed>(ra) == fa);
+	}
+}
+
+TEST_CASE("Test RnsNum base extension recovers the missing lanes", "[rns_extend]") {
+	auto testVals = GENERATE(take(200, pair_random<std::uint64_t>(0, UINT64_MAX)));
+	TestFixed value = TestFixed{testVals.first} * testVals.second;
+	RnsNum<5> small{value};
+	RnsNum<13> full{value};
+	INFO("a = " << testVals.first << " b = " << testVals.second);
+	CHECK(small.extend<13>() == full);
+	// Lanes 8..13 hold five primes, enough for a 128 bit value on their own.
+	// base_extend overwrites every other lane without reading it
+	RnsNum<13> partial{full};
+	CHECK(partial.base_extend(8, 13) == full);
+	CHECK(partial.residues().size() == 13);
+}
+
+TEST_CASE("Test RnsMontgomery multiplication matches mul_mod", "[rns_montgomery]") {
+	auto seed = GENERATE(take(20, random<std::uint32_t>(0, UINT32_MAX)));
+	std::minstd_rand rng{seed};
+	std::vector<std::uint32_t> limbs(5);
+	for(auto& limb : limbs) {
+		limb = rng();
+	}
+	limbs[0] |= 1;
+	TestFixed mod{};
+	mod.import_limbs(limbs.data(), limbs.size());
+	// 6 primes give M > 2^185, comfortably above 4 * P
+	RnsMontgomery<6, 12> reducer{mod};
+	TestFixed expected{1};
+	auto acc = reducer.enter(expected);
+	INFO("seed = " << seed);
+	for(std::size_t idx = 0; idx < 20; idx++) {
+		TestFixed factor = (TestFixed{rng()} * rng() * rng() * rng() * rng() * rng()) % mod;
+		expected = mul_mod(expected, factor, mod);
+		acc = reducer.mul(acc, reducer.enter(factor));
+		CHECK(reducer.leave(acc) == expected);
+	}
+}
@@ -0,0 +1,83 @@
+#include "small_vector.h"
+#include "test_helpers.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <catch2/generators/catch_generators_adapters.hpp>
+#include <catch2/generators/catch_generators_all.hpp>
+#include <cstdint>
+#include <vector>
+
+TEST_CASE("Test SmallVector", "[smallvec]") {
+	SECTION("Test Construction") {
+		SmallVector<int, 4> t{};
+		CHECK(t.size() == 0);
+		CHECK(t.is_inline());
+		SmallVector<int, 4> u{1, 2, 3};
+		CHECK(u.size() == 3);
+		CHECK(u[2] == 3);
+	}
+
+	SECTION("Stays inline until it outgrows the buffer") {
+		SmallVector<int, 4> temp{};
+		for(int idx = 0; idx < 4; idx++) {
+			temp.emplace_back(idx);
+		}
+		CHECK(temp.is_inline());
+		temp.emplace_back(4);
+		CHECK_FALSE(temp.is_inline());
+		for(int idx = 0; idx < 5; idx++) {
+			CHECK(temp[idx] == idx);
+		}
+		temp.pop_back();
+		CHECK(temp.size() == 4);
+		CHECK(temp.back() == 3);
+	}
+}
+
+TEST_CASE("Check SmallVector copies, moves and swaps", "[smallvec_copy]") {
+	auto count = GENERATE(0, 3, 8, 9, 100);
+	SmallVector<std::uint32_t, 8> a{};
+	std::vector<std::uint32_t> expected;
+	for(int idx = 0; idx < count; idx++) {
+		a.emplace_back(idx * 7);
+		expected.push_back(idx * 7);
+	}
+	auto check = [&](SmallVector<std::uint32_t, 8> const& v) {
+		REQUIRE(v.size() == expected.size());
+		CHECK(std::vector<std::uint32_t>(v.begin(), v.end()) == expected);
+	};
+
+	SmallVector<std::uint32_t, 8> b{a};
+	check(b);
+	b.emplace_back(1);
+	check(a);
+
+	SmallVector<std::uint32_t, 8> c{std::move(b)};
+	CHECK(c.size() == expected.size() + 1);
+	CHECK(b.size() == 0);
+
+	SmallVector<std::uint32_t, 8> d{5, 6};
+	d = a;
+	check(d);
+	d.swap(c);
+	CHECK(d.size() == expected.size() + 1);
+	check(c);
+	c = std::move(d);
+	CHECK(c.size() == expected.size() + 1);
+}
+
+TEST_CASE("Check SmallVector can push its own elements while growing", "[smallvec_alias]") {
+	SmallVector<std::uint32_t, 4> vec{7};
+	// Crosses the inline to heap boundary and then several heap to heap ones
+	for(std::uint32_t idx = 1; idx < 100; idx++) {
+		vec.push_back(vec[0]);
+		vec.emplace_back(vec.back());
+		vec[vec.size() - 1] += idx;
+	}
+	CHECK(vec.size() == 199);
+	for(std::size_t idx = 1; idx < vec.size(); idx += 2) {
+		CHECK(vec[idx] == 7);
+		CHECK(vec[idx + 1] == 7 + ((idx + 1) / 2));
+	}
+}
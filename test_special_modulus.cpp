@@ -0,0 +1,86 @@
+#include "special_modulus.h"
+#include "test_helpers.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <catch2/generators/catch_generators_adapters.hpp>
+#include <catch2/generators/catch_generators_all.hpp>
+#include <cstdint>
+
+using TestType = FixedBigNum<10>;
+
+// 2^bits - offset
+static TestType make_modulus(std::size_t bits, std::int64_t offset) {
+	TestType mod{0};
+	mod.set_bit(bits);
+	mod -= offset;
+	return mod;
+}
+
+// Random value of roughly 2 * 127 bits built out of the pair
+static TestType make_wide(std::int64_t a, std::int64_t b) {
+	TestType value{a};
+	value *= a;
+	value *= b;
+	value *= TestType{b} * b;
+	return value;
+}
+
+TEST_CASE("Test SpecialModulus detects special forms", "[special_detect]") {
+	auto mersenne = SpecialModulus<10>::detect(make_modulus(127, 1));
+	REQUIRE(mersenne.has_value());
+	CHECK(mersenne->bits() == 127);
+	CHECK(mersenne->offset() == 1);
+
+	auto minus = SpecialModulus<10>::detect(make_modulus(130, 5));
+	REQUIRE(minus.has_value());
+	CHECK(minus->bits() == 130);
+	CHECK(minus->offset() == 5);
+
+	auto plus = SpecialModulus<10>::detect(make_modulus(140, -27));
+	REQUIRE(plus.has_value());
+	CHECK(plus->bits() == 140);
+	CHECK(plus->offset() == -27);
+
+	CHECK_FALSE(SpecialModulus<10>::detect(make_modulus(130, 5) * 3).has_value());
+	CHECK_FALSE(SpecialModulus<10>::detect(TestType{1000003}).has_value());
+	// Products of 2^200 would not fit in 10 limbs
+	CHECK_FALSE(SpecialModulus<10>::detect(make_modulus(200, 1)).has_value());
+}
+
+TEST_CASE("Test SpecialModulus reduce matches operator%", "[special_reduce]") {
+	auto testVals = GENERATE(take(500, pair_random<std::int64_t>(INT64_MIN, INT64_MAX)));
+	auto offset = GENERATE(1, -1, 5, -27, 4294967291LL);
+	SpecialModulus<10> reducer{127, offset};
+	auto const& mod = reducer.modulus();
+	TestType value = make_wide(testVals.first, testVals.second);
+	INFO("a = " << testVals.first << " b = " << testVals.second << " c = " << offset);
+
+	TestType expected = value % mod;
+	if(expected < 0) {
+		expected += mod;
+	}
+	CHECK(reducer.reduce(value) == expected);
+
+	TestType lhs = reducer.reduce(value);
+	TestType rhs = reducer.reduce(make_wide(testVals.second, testVals.first ^ 0x5555));
+	CHECK(reducer.mul(lhs, rhs) == (lhs * rhs) % mod);
+}
+
+TEST_CASE("Test SpecialModulus runs a Lucas-Lehmer test", "[special_lucas]") {
+	// M_p = 2^p - 1 is prime iff s_(p-2) == 0 where s_0 = 4 and s_(i+1) = s_i^2 - 2
+	auto lucas_lehmer = [](std::size_t p) {
+		SpecialModulus<10> reducer{p, 1};
+		TestType s{4};
+		for(std::size_t idx = 0; idx < p - 2; idx++) {
+			s = reducer.reduce(reducer.mul(s, s) - 2);
+		}
+		return s == 0;
+	};
+	CHECK(lucas_lehmer(89));
+	CHECK(lucas_lehmer(107));
+	CHECK(lucas_lehmer(127));
+	CHECK_FALSE(lucas_lehmer(67));
+	CHECK_FALSE(lucas_lehmer(101));
+	CHECK_FALSE(lucas_lehmer(131));
+}
@@ -8,6 +8,7 @@
 #ifndef TESTNUM_H_A9029654B9334CB6AF4DC1861248C6DD
 #define TESTNUM_H_A9029654B9334CB6AF4DC1861248C6DD 1
 #include <algorithm>
+#include <bit>
 #include <compare>
 #include <cstddef>
 #include <iostream>
@@ -16,8 +17,6 @@
 #include <ostream>
 #include <utility>
 
-#include "helpers.h"
-
 // TestNum is a proof-of-concept for large integer types
 // It replicates a uint32 using only characters to test algorithms
 // for numbers that are greater than the largest integer type
@@ -435,8 +434,8 @@ inline std::pair<TestNum, TestNum> TestNum::divide_by(TestNum const& divisor) {
 	}
 
 	// Normalize data
-	auto v = divisor << clz_uint8(divisor.m_data[n]);
-	auto u = *this << clz_uint8(divisor.m_data[n]);
+	auto v = divisor << std::countl_zero(divisor.m_data[n]);
+	auto u = *this << std::countl_zero(divisor.m_data[n]);
 
 	m -= n;
 	n++;
@@ -474,11 +473,10 @@ inline std::pair<TestNum, TestNum> TestNum::simple_divide(TestNum const& t) cons
 	// divisor bigger so remainder is just the number
 	if(len_divisor > len_dividend) return {qty, remainder};
 
-	int dividend_pop_bits = (8 - clz_uint8(m_data[len_dividend])) + (len_dividend * 8);
-	int divisor_pop_bits = (8 - clz_uint8(t.m_data[len_divisor])) + (len_divisor * 8);
+	int dividend_pop_bits = std::bit_width(m_data[len_dividend]) + (len_dividend * 8);
+	int divisor_pop_bits = std::bit_width(t.m_data[len_divisor]) + (len_divisor * 8);
 	int operations = dividend_pop_bits - divisor_pop_bits;
 
-	//int operations = (((3 - len_divisor) * 8) + clz_uint8(t.m_data[len_divisor])) - (((3 - len_dividend) * 8) + clz_uint8(t.m_data[len_dividend]));
 	if(operations < 0) return {0, remainder};
 	// This may produce undefined behavior but it won't matter because the result will be discarded
 	TestNum divisor = t << operations;
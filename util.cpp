@@ -11,9 +11,20 @@
 
 #include <random>
 
+#include <fcntl.h>
+#include <unistd.h>
+
 std::string get_uuid() {
 	static UUIDv4::UUIDGenerator<std::mt19937_64> uuidGenerator;
 	auto uuid = uuidGenerator.getUUID();
 	std::string out = uuid.str();
 	return out;
 }
+
+bool sync_path(std::string const& path) {
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if(fd < 0) return false;
+	bool synced = (::fsync(fd) == 0);
+	::close(fd);
+	return synced;
+}
@@ -15,11 +15,18 @@
 
 std::string get_uuid();
 
+// Flushes the file or directory at path to stable storage, false if that failed
+bool sync_path(std::string const& path);
+
 // This is a concept to check if something is a sign agnostic
 // width 32 integer
 template<class T>
 concept width32int = (std::is_same_v<T,std::uint32_t> || std::is_same_v<T,std::int32_t>);
 
+// Any builtin integer up to 64 bits wide, used for scalar fast paths
+template<class T>
+concept scalar_int = std::is_integral_v<T> && !std::is_same_v<T,bool> && (sizeof(T) <= sizeof(std::uint64_t));
+
 // Check if hex mode
 inline bool stream_hex_mode(std::ostream & os) {
 	return (os.flags() & std::ostream::hex) != 0;